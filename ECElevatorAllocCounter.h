@@ -0,0 +1,59 @@
+#ifndef ECElevatorAllocCounter_h
+#define ECElevatorAllocCounter_h
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+//*****************************************************************************
+// Heap allocation counter for tests and benchmarks
+//
+// Replaces the global operator new/delete (plain and aligned) with versions that
+// count the calls to operator new, from any thread. Include it in exactly one
+// source file of a test or benchmark program, never in the library.
+
+inline std::atomic<long> ecElevatorNumAllocations(0);
+
+// Calls to operator new so far
+inline long ECElevatorGetNumAllocations()
+{
+    return ecElevatorNumAllocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+    ecElevatorNumAllocations.fetch_add(1, std::memory_order_relaxed);
+    if( void *p = std::malloc(size == 0 ? 1 : size) )
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+// pmr containers on the default resource come through the aligned forms
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    ecElevatorNumAllocations.fetch_add(1, std::memory_order_relaxed);
+    if( void *p = std::aligned_alloc((std::size_t)alignment, (size + (std::size_t)alignment - 1) / (std::size_t)alignment * (std::size_t)alignment) )
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+#endif /* ECElevatorAllocCounter_h */
@@ -0,0 +1,54 @@
+#include "ECElevatorArena.h"
+#include <new>
+
+using namespace std;
+
+ECElevatorArena :: ECElevatorArena(std::size_t sizeFirstChunk) : sizeFirstChunk(sizeFirstChunk), pFirstChunk(upstream.allocate(sizeFirstChunk, alignof(std::max_align_t))), chunks(pFirstChunk, sizeFirstChunk, &upstream), pool(&chunks) {
+}
+ECElevatorArena :: ~ECElevatorArena() {
+  pool.release();
+  chunks.release();
+  upstream.deallocate(pFirstChunk, sizeFirstChunk, alignof(std::max_align_t));
+}
+
+std::pmr::memory_resource *ECElevatorArena::GetResource() {
+  return &pool;
+}
+
+void ECElevatorArena::Release() {
+  // the pool hands its blocks back to the chunks, which rewind to the first one
+  pool.release();
+  chunks.release();
+  upstream.numChunks = 1;
+  upstream.numBytes = sizeFirstChunk;
+}
+
+int ECElevatorArena::GetNumChunks() const {
+  return upstream.numChunks;
+}
+
+std::size_t ECElevatorArena::GetNumBytes() const {
+  return upstream.numBytes;
+}
+
+// ********************* counting upstream ********************
+
+void *ECElevatorArena::ECCountingResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+  void *p = (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ? ::operator new(bytes, std::align_val_t(alignment)) : ::operator new(bytes);
+  ++numChunks;
+  numBytes += bytes;
+  return p;
+}
+
+void ECElevatorArena::ECCountingResource::do_deallocate(void *p, std::size_t, std::size_t alignment) {
+  if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    ::operator delete(p, std::align_val_t(alignment));
+  }
+  else {
+    ::operator delete(p);
+  }
+}
+
+bool ECElevatorArena::ECCountingResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+  return this == &other;
+}
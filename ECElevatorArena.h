@@ -0,0 +1,58 @@
+#ifndef ECElevatorArena_h
+#define ECElevatorArena_h
+
+#include <cstddef>
+#include <memory_resource>
+
+//*****************************************************************************
+// Memory arena for simulation runs
+//
+// Everything a run allocates (the cars of a bank, the call index, per-floor
+// registers, board times...) comes out of big chunks; small blocks freed during
+// the run go back to a pool for reuse. Nothing is freed one block at a time:
+// Release drops the whole run at once and keeps the first chunk, so the next run
+// on the same arena starts on memory that is already mapped and in cache.
+// Pass GetResource() to the ECElevatorSim / ECElevatorBank constructors, and
+// destroy them before Release. Not thread safe: one arena per thread.
+
+class ECElevatorArena
+{
+public:
+    // sizeFirstChunk: bytes of the first chunk (later ones grow geometrically);
+    // the default holds a bank of a few cars of 200 floors
+    explicit ECElevatorArena(std::size_t sizeFirstChunk = 256 * 1024);
+    ~ECElevatorArena();
+    ECElevatorArena(const ECElevatorArena &) = delete;
+    ECElevatorArena &operator=(const ECElevatorArena &) = delete;
+
+    std::pmr::memory_resource *GetResource();
+
+    // Free everything allocated from the arena; the chunks past the first go back to the heap
+    void Release();
+
+    // Chunks taken from the heap (first one included) and their total size
+    int GetNumChunks() const;
+    std::size_t GetNumBytes() const;
+
+private:
+    // heap, counted
+    class ECCountingResource : public std::pmr::memory_resource
+    {
+    public:
+        int numChunks = 0;
+        std::size_t numBytes = 0;
+
+    private:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+    };
+
+    ECCountingResource upstream;
+    std::size_t sizeFirstChunk;
+    void *pFirstChunk;
+    std::pmr::monotonic_buffer_resource chunks;
+    std::pmr::unsynchronized_pool_resource pool;
+};
+
+#endif /* ECElevatorArena_h */
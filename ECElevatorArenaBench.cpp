@@ -0,0 +1,138 @@
+#include "ECElevatorSim.h"
+#include "ECElevatorBank.h"
+#include "ECElevatorArena.h"
+#include "ECElevatorThreadPool.h"
+#include "ECElevatorTraffic.h"
+#include "ECElevatorAllocCounter.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Per-run allocation: many short runs with the default allocator vs one ECElevatorArena per run
+//     ECElevatorArenaBench [--runs N] [--floors N] [--requests N] [--cars N] [--threads N]
+// Each run builds a bank (or a single car with --cars 1) over its own copy of the requests,
+// simulates it and tears it down; the arena case takes everything from its thread's arena,
+// released after each run.
+// --threads: also run both cases on an ECElevatorThreadPool (0: one thread per core)
+// One CSV line per case:
+//   allocator        default or arena
+//   ns_per_run       wall time / runs
+//   allocs_per_run   calls to operator new per run (arena: the copy of the requests, plus chunks past the first)
+
+static int RunOne(int numFloors, int numCars, int lenSim, const std::vector<ECElevatorSimRequest> &listTraffic, std::pmr::memory_resource *pResource)
+{
+    std::vector<ECElevatorSimRequest> listRequests(listTraffic);
+    if( numCars > 1 )
+    {
+        ECElevatorBank bank(numFloors, numCars, listRequests, pResource);
+        bank.Simulate(lenSim);
+    }
+    else
+    {
+        ECElevatorSim sim(numFloors, listRequests, true, pResource);
+        sim.Simulate(lenSim);
+    }
+    int numServiced = 0;
+    for(auto &request : listRequests)
+    {
+        numServiced += request.IsServiced();
+    }
+    return numServiced;
+}
+
+static void RunCase(bool fArena, int numThreads, int numRuns, int numFloors, int numCars, int lenSim, const std::vector<ECElevatorSimRequest> &listTraffic)
+{
+    std::atomic<long> numServiced(0);
+    auto run = [&](int)
+    {
+        int n;
+        if( fArena )
+        {
+            // one arena per thread, rewound after each run
+            static thread_local ECElevatorArena arena;
+            n = RunOne(numFloors, numCars, lenSim, listTraffic, arena.GetResource());
+            arena.Release();
+        }
+        else
+        {
+            n = RunOne(numFloors, numCars, lenSim, listTraffic, std::pmr::get_default_resource());
+        }
+        numServiced += n;
+    };
+
+    long numAllocationsBefore = ECElevatorGetNumAllocations();
+    auto tmStart = std::chrono::steady_clock::now();
+    if( numThreads < 0 )
+    {
+        for(int i=0; i<numRuns; ++i)
+        {
+            run(i);
+        }
+    }
+    else
+    {
+        ECElevatorThreadPool pool(numThreads);
+        numThreads = pool.GetNumThreads();
+        numAllocationsBefore = ECElevatorGetNumAllocations();
+        tmStart = std::chrono::steady_clock::now();
+        pool.ParallelFor(numRuns, run);
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+    long numAllocs = ECElevatorGetNumAllocations() - numAllocationsBefore;
+    printf("%s,%d,%d,%d,%d,%d,%.0f,%.1f,%.1f\n", fArena ? "arena" : "default", numThreads < 0 ? 1 : numThreads, numRuns, numFloors, (int)listTraffic.size(), numCars,
+        1e9 * secs / numRuns, (double)numAllocs / numRuns, (double)numServiced / numRuns);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+    int numRuns = 20000;
+    int numFloors = 20;
+    int numRequests = 200;
+    int numCars = 4;
+    int numThreads = -1;
+    for(int i=1; i<argc; ++i)
+    {
+        if( strcmp(argv[i], "--runs") == 0 && i+1 < argc )
+        {
+            numRuns = atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--floors") == 0 && i+1 < argc )
+        {
+            numFloors = atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--requests") == 0 && i+1 < argc )
+        {
+            numRequests = atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--cars") == 0 && i+1 < argc )
+        {
+            numCars = atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--threads") == 0 && i+1 < argc )
+        {
+            numThreads = atoi(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--runs N] [--floors N] [--requests N] [--cars N] [--threads N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<ECElevatorSimRequest> listTraffic;
+    ECElevatorGenerateTraffic(EC_TRAFFIC_INTER_FLOOR, numFloors, numRequests, 0.5, 11, listTraffic);
+    int lenSim = listTraffic.back().GetTime() + 10 * numFloors + 100;
+
+    printf("allocator,threads,runs,floors,requests,cars,ns_per_run,allocs_per_run,serviced_per_run\n");
+    RunCase(false, -1, numRuns, numFloors, numCars, lenSim, listTraffic);
+    RunCase(true, -1, numRuns, numFloors, numCars, lenSim, listTraffic);
+    if( numThreads >= 0 )
+    {
+        RunCase(false, numThreads, numRuns, numFloors, numCars, lenSim, listTraffic);
+        RunCase(true, numThreads, numRuns, numFloors, numCars, lenSim, listTraffic);
+    }
+    return 0;
+}
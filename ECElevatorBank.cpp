@@ -0,0 +1,140 @@
+#include "ECElevatorBank.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+ECElevatorBank :: ECElevatorBank(int numFloors, int numCars, std::vector<ECElevatorSimRequest> &listRequests, std::pmr::memory_resource *pResource) : numFloors(numFloors), pResource(pResource), listRequests(listRequests), listCars(pResource), listCarOfRequest(listRequests.size(), -1, pResource), listActivation(pResource), nextActivation(0), currTime(0), numSkippedTicks(0) {
+  std::pmr::polymorphic_allocator<ECElevatorSim> alloc(pResource);
+  // requests are always given to some car
+  numCars = max(numCars, 1);
+  for (int i = 0; i < numCars; ++i) {
+    ECElevatorSim *pCar = alloc.allocate(1);
+    alloc.construct(pCar, numFloors, listRequests, false, pResource);
+    listCars.push_back(pCar);
+  }
+  // requests are assigned in time order (ties: in list order)
+  listActivation.resize(listRequests.size());
+  for (unsigned int i = 0; i < listActivation.size(); ++i) {
+    listActivation[i] = i;
+  }
+  std::sort(listActivation.begin(), listActivation.end(), [&listRequests](int a, int b) {
+    int timeA = listRequests[a].GetTime(), timeB = listRequests[b].GetTime();
+    return timeA < timeB || (timeA == timeB && a < b);
+  });
+}
+ECElevatorBank :: ~ECElevatorBank() {
+  std::pmr::polymorphic_allocator<ECElevatorSim> alloc(pResource);
+  for (auto pCar : listCars) {
+    pCar->~ECElevatorSim();
+    alloc.deallocate(pCar, 1);
+  }
+}
+
+void ECElevatorBank::Simulate(int lenSim) {
+  while (currTime < lenSim) {
+    SkipIdleTicks(lenSim);
+    if (currTime >= lenSim) {
+      break;
+    }
+    AdvanceOneTick();
+  }
+}
+
+void ECElevatorBank::AdvanceOneTick() {
+  ActivateDueRequests();
+  for (auto pCar : listCars) {
+    pCar->AdvanceOneTick();
+  }
+  ++currTime;
+}
+
+void ECElevatorBank::ActivateDueRequests() {
+  while (nextActivation < listActivation.size() && listRequests[listActivation[nextActivation]].GetTime() <= currTime) {
+    int id = listActivation[nextActivation++];
+    int car = ChooseCar(listRequests[id]);
+    if (listCars[car]->AssignRequest(id)) {
+      listCarOfRequest[id] = car;
+    }
+  }
+}
+
+void ECElevatorBank::SkipIdleTicks(int lenSim) {
+  for (auto pCar : listCars) {
+    if (pCar->GetCurrentState()->GetType() != EC_ELEVATOR_STATE_STOP || !pCar->GetCallIndex().IsEmpty()) {
+      return;
+    }
+  }
+  int nextTime = (nextActivation < listActivation.size()) ? listRequests[listActivation[nextActivation]].GetTime() : -1;
+  if (nextTime >= 0 && nextTime <= currTime) {
+    return;
+  }
+  int skipTo = (nextTime < 0 || nextTime > lenSim) ? lenSim : nextTime;
+  if (skipTo > currTime) {
+    for (auto pCar : listCars) {
+      pCar->SetCurrDir(EC_ELEVATOR_STOPPED);
+      pCar->SetCurrentTime(skipTo);
+    }
+    numSkippedTicks += skipTo - currTime;
+    currTime = skipTo;
+  }
+}
+
+// the cheapest car wins; on a tie, the lowest numbered car
+int ECElevatorBank::ChooseCar(const ECElevatorSimRequest &request) {
+  int best = 0;
+  int bestCost = EstimateCost(*listCars[0], request);
+  for (unsigned int i = 1; i < listCars.size(); ++i) {
+    int cost = EstimateCost(*listCars[i], request);
+    if (cost < bestCost) {
+      best = i;
+      bestCost = cost;
+    }
+  }
+  return best;
+}
+
+// Rough number of ticks until the car picks up the passenger:
+// (i) parked, or passing floorSrc in the passenger's direction: straight there
+// (ii) otherwise: run to the end of the shaft in the current direction and come back
+// plus two ticks (stop + load) for every request the car already has
+int ECElevatorBank::EstimateCost(ECElevatorSim &car, const ECElevatorSimRequest &request) const {
+  int floor = car.GetCurrFloor();
+  int src = request.GetFloorSrc();
+  EC_ELEVATOR_DIR dir = car.GetCurrDir();
+  const ECElevatorCallIndex &calls = car.GetCallIndex();
+  int cost;
+  if (dir == EC_ELEVATOR_STOPPED || calls.IsEmpty()) {
+    cost = abs(floor - src);
+  }
+  else if (dir == EC_ELEVATOR_UP && src >= floor && request.IsGoingUp()) {
+    cost = src - floor;
+  }
+  else if (dir == EC_ELEVATOR_DOWN && src <= floor && !request.IsGoingUp()) {
+    cost = floor - src;
+  }
+  else {
+    int turn = (dir == EC_ELEVATOR_UP) ? numFloors : 1;
+    cost = abs(turn - floor) + abs(turn - src);
+  }
+  return cost + 2 * calls.GetNumActive();
+}
+
+int ECElevatorBank::GetNumFloors() const {
+  return numFloors;
+}
+int ECElevatorBank::GetNumCars() const {
+  return listCars.size();
+}
+ECElevatorSim& ECElevatorBank::GetCar(int i) {
+  return *listCars[i];
+}
+int ECElevatorBank::GetCarOfRequest(int id) const {
+  return listCarOfRequest[id];
+}
+int ECElevatorBank::GetCurrentTime() const {
+  return currTime;
+}
+int ECElevatorBank::GetNumSkippedTicks() const {
+  return numSkippedTicks;
+}
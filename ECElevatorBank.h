@@ -0,0 +1,60 @@
+#ifndef ECElevatorBank_h
+#define ECElevatorBank_h
+
+#include <memory_resource>
+#include <vector>
+#include "ECElevatorSim.h"
+
+//*****************************************************************************
+// A bank (group) of elevators serving the same floors and the same list of requests
+//
+// Each car is an ECElevatorSim running the usual states, but only over the requests
+// assigned to it. When a request is made, the bank hands it to the car that is
+// expected to reach floorSrc first (see EstimateCost); from then on only that car
+// stops for the passenger. All cars move in lock step, one tick at a time.
+
+class ECElevatorBank
+{
+public:
+    // numFloors: number of floors serviced (floors numbers from 1 to numFloors); numCars: cars in the bank (at least 1)
+    // pResource: where the cars and the bank's arrays come from (see ECElevatorArena)
+    ECElevatorBank(int numFloors, int numCars, std::vector<ECElevatorSimRequest> &listRequests, std::pmr::memory_resource *pResource = std::pmr::get_default_resource());
+    ~ECElevatorBank();
+
+    // Simulate from time 0 up to lenSim (same as ECElevatorSim::Simulate)
+    void Simulate(int lenSim);
+
+    // Assign the requests made now and move every car by one tick
+    void AdvanceOneTick();
+
+    int GetNumFloors() const;
+    int GetNumCars() const;
+    ECElevatorSim& GetCar(int i);
+
+    // Car serving request id; -1 if it is not made yet (or can't be served)
+    int GetCarOfRequest(int id) const;
+
+    int GetCurrentTime() const;
+
+    // Number of ticks skipped while every car was parked with nothing to do
+    int GetNumSkippedTicks() const;
+
+private:
+    void ActivateDueRequests();
+    void SkipIdleTicks(int lenSim);
+    int ChooseCar(const ECElevatorSimRequest &request);
+    int EstimateCost(ECElevatorSim &car, const ECElevatorSimRequest &request) const;
+
+    int numFloors;
+    std::pmr::memory_resource *pResource;
+    std::vector<ECElevatorSimRequest> &listRequests;
+    std::pmr::vector<ECElevatorSim *> listCars;
+    std::pmr::vector<int> listCarOfRequest;
+    // request ids sorted by the time they are made; the ones before nextActivation are assigned
+    std::pmr::vector<int> listActivation;
+    unsigned int nextActivation;
+    int currTime;
+    int numSkippedTicks;
+};
+
+#endif /* ECElevatorBank_h */
@@ -0,0 +1,182 @@
+#include "ECElevatorBatch.h"
+#include "ECElevatorArena.h"
+#include "ECElevatorBank.h"
+#include "ECElevatorDispatch.h"
+#include "ECElevatorRequestFile.h"
+#include "ECElevatorThreadPool.h"
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+void ECElevatorBatch::AddScenario(const ECElevatorScenario &scenario) {
+  listScenarios.push_back(scenario);
+}
+
+// a whole token as a number
+static bool ParseNumber(const std::string &token, int &value) {
+  char *pEnd = NULL;
+  long v = strtol(token.c_str(), &pEnd, 10);
+  if (token.empty() || *pEnd != '\0' || v < INT_MIN || v > INT_MAX) {
+    return false;
+  }
+  value = v;
+  return true;
+}
+
+bool ECElevatorBatch::ReadScenarioFile(const std::string &fileName) {
+  ifstream in(fileName);
+  if (!in) {
+    return false;
+  }
+  // request files are relative to the scenario file
+  std::string dir;
+  size_t posSlash = fileName.find_last_of('/');
+  if (posSlash != std::string::npos) {
+    dir = fileName.substr(0, posSlash + 1);
+  }
+  std::string line;
+  int numLine = 0;
+  while (getline(in, line)) {
+    ++numLine;
+    if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#') {
+      continue;
+    }
+    // name numFloors lenSim requestFile [numCars [dispatch]], nothing else
+    istringstream fields(line);
+    std::vector<std::string> tokens;
+    std::string token;
+    while (fields >> token) {
+      tokens.push_back(token);
+    }
+    ECElevatorScenario scenario;
+    bool fOK = tokens.size() >= 4 && tokens.size() <= 6 && ParseNumber(tokens[1], scenario.numFloors) && ParseNumber(tokens[2], scenario.lenSim);
+    if (fOK && tokens.size() >= 5) {
+      fOK = ParseNumber(tokens[4], scenario.numCars);
+    }
+    if (!fOK) {
+      cerr << fileName << ":" << numLine << ": malformed scenario line: " << line << "\n";
+      return false;
+    }
+    scenario.name = tokens[0];
+    scenario.fileRequests = tokens[3];
+    if (tokens.size() == 6) {
+      int type = ECElevatorFindDispatch(tokens[5].c_str());
+      if (type < 0) {
+        cerr << fileName << ":" << numLine << ": Unknown dispatch policy " << tokens[5] << "\n";
+        return false;
+      }
+      scenario.dispatch = (EC_ELEVATOR_DISPATCH_TYPE)type;
+    }
+    if (!scenario.fileRequests.empty() && scenario.fileRequests[0] != '/') {
+      scenario.fileRequests = dir + scenario.fileRequests;
+    }
+    AddScenario(scenario);
+  }
+  return true;
+}
+
+int ECElevatorBatch::GetNumScenarios() const {
+  return listScenarios.size();
+}
+
+void ECElevatorBatch::SetDispatch(EC_ELEVATOR_DISPATCH_TYPE dispatch) {
+  for (auto &scenario : listScenarios) {
+    scenario.dispatch = dispatch;
+  }
+}
+
+void ECElevatorBatch::Run(int numThreads) {
+  listResults.assign(listScenarios.size(), ECElevatorScenarioResult());
+  ECElevatorThreadPool pool(numThreads);
+  // each task writes its own slot: the table doesn't depend on who ran what
+  pool.ParallelFor(listScenarios.size(), [this](int i) {
+    listResults[i] = RunScenario(listScenarios[i]);
+  });
+}
+
+const std::vector<ECElevatorScenarioResult>& ECElevatorBatch::GetResults() const {
+  return listResults;
+}
+
+ECElevatorScenarioResult ECElevatorBatch::RunScenario(const ECElevatorScenario &scenario) {
+  ECElevatorScenarioResult result;
+  result.name = scenario.name;
+  result.numFloors = scenario.numFloors;
+  result.numCars = scenario.numCars;
+  result.dispatch = scenario.dispatch;
+  result.lenSim = scenario.lenSim;
+
+  std::vector<ECElevatorSimRequest> listRequests;
+  result.fLoaded = ECElevatorReadRequestFile(scenario.fileRequests, listRequests);
+  if (!result.fLoaded) {
+    return result;
+  }
+
+  // one arena per thread: everything a run allocates is dropped at once after it, and
+  // the next run on the thread starts on the first chunk, already mapped
+  static thread_local ECElevatorArena arena;
+
+  // the times come from the cars' histograms (merged for a bank)
+  ECElevatorHistogram histWait, histJourney;
+  auto tmStart = std::chrono::steady_clock::now();
+  if (scenario.numCars > 1) {
+    ECElevatorBank bank(scenario.numFloors, scenario.numCars, listRequests, arena.GetResource());
+    for (int i = 0; i < bank.GetNumCars(); ++i) {
+      bank.GetCar(i).SetDispatch(scenario.dispatch);
+    }
+    bank.Simulate(scenario.lenSim);
+    for (int i = 0; i < bank.GetNumCars(); ++i) {
+      histWait.Add(bank.GetCar(i).GetWaitHistogram());
+      histJourney.Add(bank.GetCar(i).GetJourneyHistogram());
+    }
+  }
+  else {
+    ECElevatorSim sim(scenario.numFloors, listRequests, true, arena.GetResource());
+    sim.SetDispatch(scenario.dispatch);
+    sim.Simulate(scenario.lenSim);
+    histWait.Add(sim.GetWaitHistogram());
+    histJourney.Add(sim.GetJourneyHistogram());
+  }
+  auto tmEnd = std::chrono::steady_clock::now();
+  arena.Release();
+
+  for (auto &request : listRequests) {
+    result.numRequests += !request.IsMaintenanceStart() && !request.IsMaintenanceEnd();
+  }
+  result.numServiced = histJourney.GetCount();
+  result.throughput = (scenario.lenSim > 0) ? 1000.0 * result.numServiced / scenario.lenSim : 0.0;
+  result.meanWait = histWait.GetMean();
+  result.p95Wait = histWait.GetPercentile(95);
+  result.p99Wait = histWait.GetPercentile(99);
+  result.seconds = std::chrono::duration<double>(tmEnd - tmStart).count();
+  result.ticksPerSec = (result.seconds > 0.0) ? scenario.lenSim / result.seconds : 0.0;
+  return result;
+}
+
+void ECElevatorBatch::WriteResults(std::ostream &out, bool fTiming) const {
+  out << "name,floors,cars,dispatch,ticks,requests,serviced,throughput_per_1k_ticks,mean_wait,p95_wait,p99_wait";
+  if (fTiming) {
+    out << ",seconds,ticks_per_sec";
+  }
+  out << "\n";
+  char buf[64];
+  for (auto &result : listResults) {
+    out << result.name << "," << result.numFloors << "," << result.numCars << "," << ECElevatorGetDispatchName(result.dispatch) << "," << result.lenSim << ",";
+    if (!result.fLoaded) {
+      out << "error: cannot read requests\n";
+      continue;
+    }
+    out << result.numRequests << "," << result.numServiced << ",";
+    snprintf(buf, sizeof(buf), "%.3f,%.3f", result.throughput, result.meanWait);
+    out << buf << "," << result.p95Wait << "," << result.p99Wait;
+    if (fTiming) {
+      snprintf(buf, sizeof(buf), ",%.6f,%.0f", result.seconds, result.ticksPerSec);
+      out << buf;
+    }
+    out << "\n";
+  }
+}
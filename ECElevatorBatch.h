@@ -0,0 +1,81 @@
+#ifndef ECElevatorBatch_h
+#define ECElevatorBatch_h
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ECElevatorSim.h"
+
+//*****************************************************************************
+// Batch of independent simulation scenarios run in parallel
+//
+// Scenario file: one scenario per line (blank lines and '#' lines are skipped)
+//     name numFloors lenSim requestFile [numCars [dispatch]]
+// dispatch: a policy name of ECElevatorDispatch.h (default, look, scan, nearest, destination)
+// requestFile (see ECElevatorRequestFile.h) is relative to the scenario file.
+// Results come out in scenario order no matter how many threads run them.
+
+struct ECElevatorScenario
+{
+    std::string name;
+    int numFloors = 0;
+    int lenSim = 0;
+    std::string fileRequests;
+    int numCars = 1;
+    EC_ELEVATOR_DISPATCH_TYPE dispatch = EC_DISPATCH_DEFAULT;
+};
+
+struct ECElevatorScenarioResult
+{
+    std::string name;
+    bool fLoaded = false;       // request file could be read
+    int numFloors = 0;
+    int numCars = 0;
+    EC_ELEVATOR_DISPATCH_TYPE dispatch = EC_DISPATCH_DEFAULT;
+    int lenSim = 0;
+    int numRequests = 0;
+    int numServiced = 0;
+    double throughput = 0.0;    // passengers serviced per 1000 ticks
+    // wait: request made -> passenger boarded, as ECElevatorSim::GetWaitHistogram
+    // (percentiles: within a histogram bucket)
+    double meanWait = 0.0;
+    int p95Wait = 0;
+    int p99Wait = 0;
+    // timing (depends on the machine)
+    double seconds = 0.0;
+    double ticksPerSec = 0.0;
+};
+
+class ECElevatorBatch
+{
+public:
+    void AddScenario(const ECElevatorScenario &scenario);
+
+    // Add the scenarios of a scenario file. Return false if it can't be read, or at
+    // the first malformed line (a field missing or not a number, a token past the
+    // dispatch policy) or unknown dispatch policy, reported with its line number on
+    // stderr; the scenarios before that line are kept
+    bool ReadScenarioFile(const std::string &fileName);
+
+    int GetNumScenarios() const;
+
+    // Run every scenario with this dispatch policy
+    void SetDispatch(EC_ELEVATOR_DISPATCH_TYPE dispatch);
+
+    // Run all scenarios; numThreads <= 0: one thread per core
+    void Run(int numThreads = 0);
+
+    const std::vector<ECElevatorScenarioResult>& GetResults() const;
+
+    // Result table (CSV). Leave out the timing columns to get output that only depends on the scenarios
+    void WriteResults(std::ostream &out, bool fTiming = true) const;
+
+    // Run a single scenario
+    static ECElevatorScenarioResult RunScenario(const ECElevatorScenario &scenario);
+
+private:
+    std::vector<ECElevatorScenario> listScenarios;
+    std::vector<ECElevatorScenarioResult> listResults;
+};
+
+#endif /* ECElevatorBatch_h */
@@ -0,0 +1,53 @@
+#include "ECElevatorBatch.h"
+#include "ECElevatorDispatch.h"
+#include <cstdlib>
+#include <cstring>
+
+// Batch runner: run the scenarios of a scenario file on all cores, print the result table (CSV)
+//     ECElevatorBatch scenarioFile [-j numThreads] [--no-timing] [--dispatch policy]
+// --dispatch runs every scenario with that policy (default, look, scan, nearest, destination)
+int main(int argc, char **argv)
+{
+    if( argc < 2 )
+    {
+        std::cerr << "Usage: " << argv[0] << " scenarioFile [-j numThreads] [--no-timing] [--dispatch policy]\n";
+        return 1;
+    }
+    int numThreads = 0;
+    bool fTiming = true;
+    int dispatch = -1;
+    for(int i=2; i<argc; ++i)
+    {
+        if( strcmp(argv[i], "-j") == 0 && i+1 < argc )
+        {
+            numThreads = atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--no-timing") == 0 )
+        {
+            fTiming = false;
+        }
+        else if( strcmp(argv[i], "--dispatch") == 0 && i+1 < argc )
+        {
+            dispatch = ECElevatorFindDispatch(argv[++i]);
+            if( dispatch < 0 )
+            {
+                std::cerr << "Unknown dispatch policy " << argv[i] << "\n";
+                return 1;
+            }
+        }
+    }
+
+    ECElevatorBatch batch;
+    if( !batch.ReadScenarioFile(argv[1]) )
+    {
+        std::cerr << "Cannot read scenario file " << argv[1] << "\n";
+        return 1;
+    }
+    if( dispatch >= 0 )
+    {
+        batch.SetDispatch((EC_ELEVATOR_DISPATCH_TYPE)dispatch);
+    }
+    batch.Run(numThreads);
+    batch.WriteResults(std::cout, fTiming);
+    return 0;
+}
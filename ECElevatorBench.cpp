@@ -0,0 +1,162 @@
+#include "ECElevatorSim.h"
+#include "ECElevatorDispatch.h"
+#include "ECElevatorTraffic.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/resource.h>
+
+// Simulation benchmark: ECElevatorSim::Simulate over synthetic traffic
+//     ECElevatorBench [--max-requests N] [--pattern name] [--floors N] [--rate requestsPerTick] [--capacity N] [--dispatch policy] [--fixed]
+// Default: every pattern, unlimited cabin capacity, at 10/50/200 floors with 1K/100K/1M requests (10M with --max-requests 10000000).
+// --fixed: at 8/16/32/64 floors instead, each case run by ECElevatorSim and then by ECElevatorSimT<floors>
+// One CSV line per case:
+//   sim              dynamic (ECElevatorSim) or fixed (ECElevatorSimT<floors>)
+//   ticks            simulated time (requests made until the end, then time to clear the building)
+//   decisions        ticks the states actually ran (the rest were skipped while idle)
+//   ns_per_decision  wall time / decisions
+//   peak_rss_kb      peak resident size of the process so far (cases run smallest first)
+
+static long GetPeakRSSKb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+template<int NumFloors>
+static void RunCase(EC_TRAFFIC_PATTERN pattern, int numFloors, int numRequests, double requestsPerTick, int capacity, EC_ELEVATOR_DISPATCH_TYPE dispatch)
+{
+    std::vector<ECElevatorSimRequest> listRequests;
+    ECElevatorGenerateTraffic(pattern, numFloors, numRequests, requestsPerTick, 11, listRequests);
+    // enough time after the last request for a few trips through the building
+    int lenSim = listRequests.back().GetTime() + 10 * numFloors + 100;
+
+    ECElevatorSimT<NumFloors> sim(numFloors, listRequests);
+    sim.SetCapacity(capacity);
+    sim.SetDispatch(dispatch);
+    auto tmStart = std::chrono::steady_clock::now();
+    sim.Simulate(lenSim);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+
+    int numServiced = 0;
+    for(auto &request : listRequests)
+    {
+        numServiced += request.IsServiced();
+    }
+    long numDecisions = (long)lenSim - sim.GetNumSkippedTicks();
+    printf("%s,%s,%d,%d,%.2f,%d,%s,%d,%ld,%d,%.6f,%.0f,%.0f,%.1f,%ld\n", NumFloors > 0 ? "fixed" : "dynamic", ECElevatorGetTrafficName(pattern), numFloors, numRequests, requestsPerTick, capacity, ECElevatorGetDispatchName(dispatch),
+        lenSim, numDecisions, numServiced, secs, lenSim / secs, numServiced / secs, 1e9 * secs / (numDecisions > 0 ? numDecisions : 1), GetPeakRSSKb());
+    fflush(stdout);
+}
+
+// same case with the number of floors fixed at compile time
+static void RunFixedCase(EC_TRAFFIC_PATTERN pattern, int numFloors, int numRequests, double requestsPerTick, int capacity, EC_ELEVATOR_DISPATCH_TYPE dispatch)
+{
+    switch( numFloors )
+    {
+    case 8:
+        RunCase<8>(pattern, numFloors, numRequests, requestsPerTick, capacity, dispatch);
+        break;
+    case 16:
+        RunCase<16>(pattern, numFloors, numRequests, requestsPerTick, capacity, dispatch);
+        break;
+    case 32:
+        RunCase<32>(pattern, numFloors, numRequests, requestsPerTick, capacity, dispatch);
+        break;
+    case 64:
+        RunCase<64>(pattern, numFloors, numRequests, requestsPerTick, capacity, dispatch);
+        break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int maxRequests = 1000000;
+    int patternOnly = -1;
+    int floorsOnly = 0;
+    double requestsPerTick = 0.5;
+    int capacity = 0;
+    int dispatch = EC_DISPATCH_DEFAULT;
+    bool fFixed = false;
+    for(int i=1; i<argc; ++i)
+    {
+        if( strcmp(argv[i], "--max-requests") == 0 && i+1 < argc )
+        {
+            maxRequests = atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--pattern") == 0 && i+1 < argc )
+        {
+            patternOnly = ECElevatorFindTrafficPattern(argv[++i]);
+            if( patternOnly < 0 )
+            {
+                fprintf(stderr, "Unknown pattern %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if( strcmp(argv[i], "--floors") == 0 && i+1 < argc )
+        {
+            floorsOnly = atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--rate") == 0 && i+1 < argc )
+        {
+            requestsPerTick = atof(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--capacity") == 0 && i+1 < argc )
+        {
+            capacity = atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--dispatch") == 0 && i+1 < argc )
+        {
+            dispatch = ECElevatorFindDispatch(argv[++i]);
+            if( dispatch < 0 )
+            {
+                fprintf(stderr, "Unknown dispatch policy %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if( strcmp(argv[i], "--fixed") == 0 )
+        {
+            fFixed = true;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--max-requests N] [--pattern up-peak|down-peak|lunch|inter-floor] [--floors N] [--rate requestsPerTick] [--capacity N] [--dispatch default|look|scan|nearest|destination] [--fixed]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("sim,pattern,floors,requests,requests_per_tick,capacity,dispatch,ticks,decisions,serviced,secs,ticks_per_sec,requests_per_sec,ns_per_decision,peak_rss_kb\n");
+    for(int numRequests : {1000, 100000, 1000000, 10000000})
+    {
+        if( numRequests > maxRequests )
+        {
+            break;
+        }
+        std::vector<int> listFloors = fFixed ? std::vector<int>{8, 16, 32, 64} : std::vector<int>{10, 50, 200};
+        for(int numFloors : listFloors)
+        {
+            if( floorsOnly > 0 && numFloors != floorsOnly )
+            {
+                continue;
+            }
+            for(int p = 0; p < EC_TRAFFIC_NUM_PATTERNS; ++p)
+            {
+                if( patternOnly < 0 || p == patternOnly )
+                {
+                    RunCase<0>((EC_TRAFFIC_PATTERN)p, numFloors, numRequests, requestsPerTick, capacity, (EC_ELEVATOR_DISPATCH_TYPE)dispatch);
+                    if( fFixed )
+                    {
+                        RunFixedCase((EC_TRAFFIC_PATTERN)p, numFloors, numRequests, requestsPerTick, capacity, (EC_ELEVATOR_DISPATCH_TYPE)dispatch);
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
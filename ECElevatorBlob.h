@@ -0,0 +1,98 @@
+#ifndef ECElevatorBlob_h
+#define ECElevatorBlob_h
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//*****************************************************************************
+// Compact binary encoding for checkpoints
+//
+// Integers are written as varints (7 bits per byte, small values take one byte);
+// signed ones are zigzag encoded first so that small negative values stay small.
+// The reader never reads past the end: once anything is missing or malformed it
+// turns bad and returns zeros from then on.
+
+class ECElevatorBlobWriter
+{
+public:
+    explicit ECElevatorBlobWriter(std::vector<uint8_t> &bytesIn) : bytes(bytesIn) {}
+
+    void WriteByte(uint8_t b) { bytes.push_back(b); }
+    void WriteBytes(const void *p, size_t size)
+    {
+        const uint8_t *pb = (const uint8_t *)p;
+        bytes.insert(bytes.end(), pb, pb + size);
+    }
+    void WriteUnsigned(uint64_t v)
+    {
+        while( v >= 0x80 )
+        {
+            bytes.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        bytes.push_back((uint8_t)v);
+    }
+    void WriteSigned(int64_t v) { WriteUnsigned(((uint64_t)v << 1) ^ (uint64_t)(v >> 63)); }
+
+private:
+    std::vector<uint8_t> &bytes;
+};
+
+class ECElevatorBlobReader
+{
+public:
+    ECElevatorBlobReader(const uint8_t *pBytesIn, size_t sizeIn) : pBytes(pBytesIn), size(sizeIn), pos(0), fBad(false) {}
+
+    bool IsBad() const { return fBad; }
+    bool IsAtEnd() const { return pos == size; }
+
+    uint8_t ReadByte()
+    {
+        if( fBad || pos >= size )
+        {
+            fBad = true;
+            return 0;
+        }
+        return pBytes[pos++];
+    }
+    bool ReadBytes(void *p, size_t n)
+    {
+        if( fBad || size - pos < n )
+        {
+            fBad = true;
+            return false;
+        }
+        memcpy(p, pBytes + pos, n);
+        pos += n;
+        return true;
+    }
+    uint64_t ReadUnsigned()
+    {
+        uint64_t v = 0;
+        for(int shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t b = ReadByte();
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if( (b & 0x80) == 0 )
+            {
+                return fBad ? 0 : v;
+            }
+        }
+        fBad = true;
+        return 0;
+    }
+    int64_t ReadSigned()
+    {
+        uint64_t v = ReadUnsigned();
+        return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    }
+
+private:
+    const uint8_t *pBytes;
+    size_t size;
+    size_t pos;
+    bool fBad;
+};
+
+#endif /* ECElevatorBlob_h */
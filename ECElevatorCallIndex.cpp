@@ -0,0 +1,293 @@
+#include "ECElevatorCallIndex.h"
+#include "ECElevatorSim.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+template<int NumFloors>
+ECElevatorCallIndexT<NumFloors> :: ECElevatorCallIndexT(int numFloors, int numRequests, std::pmr::memory_resource *pResource) : numFloors(numFloors), hallUp(pResource), hallDown(pResource), car(pResource), dest(pResource), regHallUp(pResource), regHallDown(pResource), regCarCalls(pResource), regDests(pResource), callNext(pResource), callPrev(pResource), destNext(pResource), destPrev(pResource), listActive(pResource), listActivePos(pResource) {
+  assert(NumFloors == 0 || numFloors == NumFloors);
+  Reset();
+  Reserve(numRequests);
+}
+
+template<int NumFloors>
+void ECElevatorCallIndexT<NumFloors>::Reset() {
+  hallUp.Init(numFloors, Bucket());
+  hallDown.Init(numFloors, Bucket());
+  car.Init(numFloors, Bucket());
+  dest.Init(numFloors, Bucket());
+  regHallUp.Init(numFloors);
+  regHallDown.Init(numFloors);
+  regCarCalls.Init(numFloors);
+  regDests.Init(numFloors);
+  // same sizes: the arrays are filled in place
+  fill(callNext.begin(), callNext.end(), -1);
+  fill(callPrev.begin(), callPrev.end(), -1);
+  fill(destNext.begin(), destNext.end(), -1);
+  fill(destPrev.begin(), destPrev.end(), -1);
+  fill(listActivePos.begin(), listActivePos.end(), -1);
+  listActive.clear();
+}
+
+template<int NumFloors>
+void ECElevatorCallIndexT<NumFloors>::Reserve(int numRequests) {
+  if (numRequests > (int)callNext.size()) {
+    callNext.resize(numRequests, -1);
+    callPrev.resize(numRequests, -1);
+    destNext.resize(numRequests, -1);
+    destPrev.resize(numRequests, -1);
+    listActivePos.resize(numRequests, -1);
+    listActive.reserve(listActivePos.capacity());
+  }
+}
+
+// ********************* bucket lists *************************
+template<int NumFloors>
+void ECElevatorCallIndexT<NumFloors>::Insert(Bucket &bucket, std::pmr::vector<int> &next, std::pmr::vector<int> &prev, int id) {
+  // requests mostly come in list order, so look for the spot from the back
+  int after = bucket.tail;
+  while (after >= 0 && after > id) {
+    after = prev[after];
+  }
+  int before = (after >= 0) ? next[after] : bucket.head;
+  prev[id] = after;
+  next[id] = before;
+  if (after >= 0) {
+    next[after] = id;
+  }
+  else {
+    bucket.head = id;
+  }
+  if (before >= 0) {
+    prev[before] = id;
+  }
+  else {
+    bucket.tail = id;
+  }
+  ++bucket.count;
+}
+template<int NumFloors>
+void ECElevatorCallIndexT<NumFloors>::Erase(Bucket &bucket, std::pmr::vector<int> &next, std::pmr::vector<int> &prev, int id) {
+  if (prev[id] >= 0) {
+    next[prev[id]] = next[id];
+  }
+  else {
+    bucket.head = next[id];
+  }
+  if (next[id] >= 0) {
+    prev[next[id]] = prev[id];
+  }
+  else {
+    bucket.tail = prev[id];
+  }
+  next[id] = prev[id] = -1;
+  --bucket.count;
+}
+
+// ********************* request lifecycle ********************
+template<int NumFloors>
+bool ECElevatorCallIndexT<NumFloors>::Activate(int id, const ECElevatorSimRequest &request) {
+  int floorSrc = request.GetFloorSrc();
+  int floorDest = request.GetFloorDest();
+  if (request.IsServiced() || !IsValidFloor(floorSrc) || !IsValidFloor(floorDest)) {
+    return false;
+  }
+  Reserve(id + 1);
+  if (request.IsFloorRequestDone()) {
+    Insert(car[floorDest], callNext, callPrev, id);
+    Mark(regCarCalls, car[floorDest], floorDest);
+  }
+  else if (request.IsGoingUp()) {
+    Insert(hallUp[floorSrc], callNext, callPrev, id);
+    Mark(regHallUp, hallUp[floorSrc], floorSrc);
+  }
+  else {
+    Insert(hallDown[floorSrc], callNext, callPrev, id);
+    Mark(regHallDown, hallDown[floorSrc], floorSrc);
+  }
+  Insert(dest[floorDest], destNext, destPrev, id);
+  Mark(regDests, dest[floorDest], floorDest);
+  listActivePos[id] = listActive.size();
+  listActive.push_back(id);
+  return true;
+}
+template<int NumFloors>
+void ECElevatorCallIndexT<NumFloors>::Board(int id, const ECElevatorSimRequest &request) {
+  int floorSrc = request.GetFloorSrc();
+  int floorDest = request.GetFloorDest();
+  if (request.IsGoingUp()) {
+    Erase(hallUp[floorSrc], callNext, callPrev, id);
+    Mark(regHallUp, hallUp[floorSrc], floorSrc);
+  }
+  else {
+    Erase(hallDown[floorSrc], callNext, callPrev, id);
+    Mark(regHallDown, hallDown[floorSrc], floorSrc);
+  }
+  Insert(car[floorDest], callNext, callPrev, id);
+  Mark(regCarCalls, car[floorDest], floorDest);
+}
+template<int NumFloors>
+void ECElevatorCallIndexT<NumFloors>::Arrive(int id, const ECElevatorSimRequest &request) {
+  int floorDest = request.GetFloorDest();
+  Erase(car[floorDest], callNext, callPrev, id);
+  Mark(regCarCalls, car[floorDest], floorDest);
+  Erase(dest[floorDest], destNext, destPrev, id);
+  Mark(regDests, dest[floorDest], floorDest);
+  // swap-remove from the active list
+  int pos = listActivePos[id];
+  listActive[pos] = listActive.back();
+  listActivePos[listActive[pos]] = pos;
+  listActive.pop_back();
+  listActivePos[id] = -1;
+}
+
+// ************************* bit scans ************************
+template<int NumFloors>
+template<class TWord>
+int ECElevatorCallIndexT<NumFloors>::ScanAbove(int floor, TWord word) const {
+  int bit = max(floor + 1, 0);
+  int i = bit >> 6;
+  int numWords = regDests.GetNumWords();
+  if (i >= numWords) {
+    return -1;
+  }
+  uint64_t w = word(i) & (~uint64_t(0) << (bit & 63));
+  while (w == 0) {
+    if (++i >= numWords) {
+      return -1;
+    }
+    w = word(i);
+  }
+  return (i << 6) + ECElevatorCountTrailingZeros(w);
+}
+template<int NumFloors>
+template<class TWord>
+int ECElevatorCallIndexT<NumFloors>::ScanBelow(int floor, TWord word) const {
+  if (floor <= 1) {
+    return -1;
+  }
+  int bit = min(floor - 1, GetNumFloors());
+  int i = bit >> 6;
+  uint64_t w = word(i) & (~uint64_t(0) >> (63 - (bit & 63)));
+  while (w == 0) {
+    if (--i < 0) {
+      return -1;
+    }
+    w = word(i);
+  }
+  return (i << 6) + 63 - ECElevatorCountLeadingZeros(w);
+}
+
+// ************************* queries **************************
+template<int NumFloors>
+bool ECElevatorCallIndexT<NumFloors>::IsActive(int id) const {
+  return id >= 0 && id < (int)listActivePos.size() && listActivePos[id] >= 0;
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::GetNumHallCalls(int floor, bool goingUp) const {
+  if (!IsValidFloor(floor)) {
+    return 0;
+  }
+  return goingUp ? hallUp[floor].count : hallDown[floor].count;
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::GetNumCarCalls(int floor) const {
+  return IsValidFloor(floor) ? car[floor].count : 0;
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::FirstHallCall(int floor, bool goingUp) const {
+  if (!IsValidFloor(floor)) {
+    return -1;
+  }
+  return goingUp ? hallUp[floor].head : hallDown[floor].head;
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::FirstCarCall(int floor) const {
+  return IsValidFloor(floor) ? car[floor].head : -1;
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::Count(int floor, bool fCarOnly) const {
+  return (fCarOnly ? 0 : hallUp[floor].count + hallDown[floor].count) + car[floor].count;
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::FirstRequestAt(int floor, bool fCarOnly) const {
+  if (fCarOnly) {
+    return FirstCarCall(floor);
+  }
+  int first = -1;
+  for (int id : {FirstHallCall(floor, true), FirstHallCall(floor, false), FirstCarCall(floor)}) {
+    if (id >= 0 && (first < 0 || id < first)) {
+      first = id;
+    }
+  }
+  return first;
+}
+template<int NumFloors>
+bool ECElevatorCallIndexT<NumFloors>::HasRequestAt(int floor, bool fCarOnly) const {
+  return IsValidFloor(floor) && Count(floor, fCarOnly) > 0;
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::NextRequestAbove(int floor, bool fCarOnly) const {
+  return ScanAbove(floor, [this, fCarOnly](int i) { return GetCallWord(i, fCarOnly); });
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::NextRequestBelow(int floor, bool fCarOnly) const {
+  return ScanBelow(floor, [this, fCarOnly](int i) { return GetCallWord(i, fCarOnly); });
+}
+template<int NumFloors>
+bool ECElevatorCallIndexT<NumFloors>::HasRequestAbove(int floor, bool fCarOnly) const {
+  return NextRequestAbove(floor, fCarOnly) >= 0;
+}
+template<int NumFloors>
+bool ECElevatorCallIndexT<NumFloors>::HasRequestBelow(int floor, bool fCarOnly) const {
+  return NextRequestBelow(floor, fCarOnly) >= 0;
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::NearestRequestFloor(int floor, bool fCarOnly) const {
+  if (HasRequestAt(floor, fCarOnly)) {
+    return floor;
+  }
+  int above = NextRequestAbove(floor, fCarOnly);
+  int below = NextRequestBelow(floor, fCarOnly);
+  if (above < 0 || below < 0) {
+    return (above >= 0) ? above : below;
+  }
+  if (above - floor != floor - below) {
+    return (above - floor < floor - below) ? above : below;
+  }
+  // same distance: the floor of the first request
+  return (FirstRequestAt(below, fCarOnly) < FirstRequestAt(above, fCarOnly)) ? below : above;
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::FirstDestAt(int floor) const {
+  return IsValidFloor(floor) ? dest[floor].head : -1;
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::GetNumDestAt(int floor) const {
+  return IsValidFloor(floor) ? dest[floor].count : 0;
+}
+template<int NumFloors>
+bool ECElevatorCallIndexT<NumFloors>::HasDestBelow(int floor) const {
+  return ScanBelow(floor, [this](int i) { return regDests.GetWord(i); }) >= 0;
+}
+template<int NumFloors>
+int ECElevatorCallIndexT<NumFloors>::NearestDestDistance(int floor) const {
+  if (GetNumDestAt(floor) > 0) {
+    return 0;
+  }
+  int above = ScanAbove(floor, [this](int i) { return regDests.GetWord(i); });
+  int below = ScanBelow(floor, [this](int i) { return regDests.GetWord(i); });
+  if (above < 0 || below < 0) {
+    return (above >= 0) ? above - floor : (below >= 0) ? floor - below : -1;
+  }
+  return min(above - floor, floor - below);
+}
+
+// the sizes ECElevatorSimT is built for (ECElevatorSim.h)
+template class ECElevatorCallIndexT<0>;
+template class ECElevatorCallIndexT<8>;
+template class ECElevatorCallIndexT<16>;
+template class ECElevatorCallIndexT<32>;
+template class ECElevatorCallIndexT<64>;
@@ -0,0 +1,235 @@
+#ifndef ECElevatorCallIndex_h
+#define ECElevatorCallIndex_h
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+#if __cplusplus >= 202002L
+#include <bit>
+#endif
+
+class ECElevatorSimRequest;
+
+//*****************************************************************************
+// Per-floor storage (floors 1..numFloors; 0 is not used)
+// NumFloors > 0: the number of floors is known at compile time and the items sit
+// in the object itself; 0: it is given at run time (allocated from pResource)
+
+template<class T, int NumFloors>
+class ECElevatorFloorArray
+{
+public:
+    explicit ECElevatorFloorArray(std::pmr::memory_resource *) {}
+    void Init(int, const T &value) { items.fill(value); }
+    T& operator[](int floor) { return items[floor]; }
+    const T& operator[](int floor) const { return items[floor]; }
+private:
+    std::array<T, NumFloors + 1> items;
+};
+
+template<class T>
+class ECElevatorFloorArray<T, 0>
+{
+public:
+    explicit ECElevatorFloorArray(std::pmr::memory_resource *pResource) : items(pResource) {}
+    void Init(int numFloors, const T &value) { items.assign(numFloors + 1, value); }
+    T& operator[](int floor) { return items[floor]; }
+    const T& operator[](int floor) const { return items[floor]; }
+private:
+    std::pmr::vector<T> items;
+};
+
+//*****************************************************************************
+// One bit per floor (bit f: floor f), 64 floors to a word: is there anything at
+// that floor. Bit 0 and the bits past the last floor are never set.
+
+inline int ECElevatorCountTrailingZeros(uint64_t x)
+{
+#if defined(__cpp_lib_bitops)
+    return std::countr_zero(x);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+inline int ECElevatorCountLeadingZeros(uint64_t x)
+{
+#if defined(__cpp_lib_bitops)
+    return std::countl_zero(x);
+#else
+    return __builtin_clzll(x);
+#endif
+}
+
+template<int NumFloors>
+class ECElevatorFloorRegister
+{
+public:
+    explicit ECElevatorFloorRegister(std::pmr::memory_resource *pResource) : words(MakeWords(pResource)) {}
+    void Init(int numFloors)
+    {
+        if constexpr (NumFloors > 0)
+        {
+            words.fill(0);
+        }
+        else
+        {
+            words.assign(numFloors / 64 + 1, 0);
+        }
+    }
+    void Set(int floor, bool f)
+    {
+        uint64_t bit = uint64_t(1) << (floor & 63);
+        words[floor >> 6] = f ? (words[floor >> 6] | bit) : (words[floor >> 6] & ~bit);
+    }
+    int GetNumWords() const { return words.size(); }
+    uint64_t GetWord(int i) const { return words[i]; }
+
+private:
+    typedef typename std::conditional<(NumFloors > 0), std::array<uint64_t, NumFloors / 64 + 1>, std::pmr::vector<uint64_t>>::type Words;
+    static Words MakeWords(std::pmr::memory_resource *pResource)
+    {
+        if constexpr (NumFloors > 0)
+        {
+            return Words();
+        }
+        else
+        {
+            return Words(pResource);
+        }
+    }
+    Words words;
+};
+
+//*****************************************************************************
+// Index of the requests that are in play right now, bucketed by floor
+//
+// (i) hall calls: passengers waiting at floorSrc, split by the way they go (up/down)
+// (ii) car calls: passengers inside the elevator, bucketed by floorDest
+// (iii) destinations: every active request (waiting or riding) by floorDest;
+// ECElevatorStopOver decides its direction from these
+//
+// A request is referred to by its position (id) in the request list. Each bucket
+// keeps its ids sorted, so "the first request at a floor" means the same thing as
+// it did when the states scanned the whole list in order.
+// Buckets are intrusive lists over preallocated link arrays: no allocation once
+// the index is sized.
+// Like the call registers of a real controller, a bit mask per kind of bucket (up
+// calls, down calls, car calls, destinations) marks the floors that have any:
+// "anything above/below", "next floor going up/down" and "nearest floor" are
+// bit scans over numFloors/64 words, whatever the number of requests.
+// NumFloors > 0 (see ECElevatorSimT): buckets and masks are fixed arrays.
+
+template<int NumFloors>
+class ECElevatorCallIndexT
+{
+public:
+    // numFloors: must be NumFloors if that is not 0
+    // pResource: where the arrays come from (e.g., an ECElevatorArena)
+    ECElevatorCallIndexT(int numFloors, int numRequests, std::pmr::memory_resource *pResource = std::pmr::get_default_resource());
+
+    // make room for ids up to numRequests-1
+    void Reserve(int numRequests);
+
+    // Empty the index (e.g., before the ids are renumbered), keeping its storage
+    void Reset();
+
+    // Request becomes active (i.e., it is made at or before the current time).
+    // Requests outside of floors 1..numFloors are not indexed; return false for these
+    bool Activate(int id, const ECElevatorSimRequest &request);
+
+    // Passenger boarded: the hall call at floorSrc becomes a car call to floorDest
+    void Board(int id, const ECElevatorSimRequest &request);
+
+    // Passenger arrived at floorDest: request leaves the index
+    void Arrive(int id, const ECElevatorSimRequest &request);
+
+    // Is request id in the index
+    bool IsActive(int id) const;
+
+    // Number of active requests (waiting or riding)
+    int GetNumActive() const { return listActive.size(); }
+    bool IsEmpty() const { return listActive.empty(); }
+
+    // Ids of the active requests, in no particular order: serviced requests are
+    // swap-removed as they arrive, so going over these costs only what is in flight
+    const std::pmr::vector<int>& GetActiveRequests() const { return listActive; }
+
+    // Number of hall calls at a floor in a direction; number of car calls to a floor
+    int GetNumHallCalls(int floor, bool goingUp) const;
+    int GetNumCarCalls(int floor) const;
+
+    // First (lowest id) hall call / car call at a floor; -1 if none
+    int FirstHallCall(int floor, bool goingUp) const;
+    int FirstCarCall(int floor) const;
+
+    // Requested floor: floorSrc of a waiting passenger, floorDest of a riding one
+    // (fCarOnly: riding ones only, e.g. when the car is full)
+    // First request whose requested floor is this floor; -1 if none
+    int FirstRequestAt(int floor, bool fCarOnly = false) const;
+    bool HasRequestAt(int floor, bool fCarOnly = false) const;
+    bool HasRequestAbove(int floor, bool fCarOnly = false) const;
+    bool HasRequestBelow(int floor, bool fCarOnly = false) const;
+
+    // Next requested floor above / below floor (the next stop going up / down); -1 if none
+    int NextRequestAbove(int floor, bool fCarOnly = false) const;
+    int NextRequestBelow(int floor, bool fCarOnly = false) const;
+
+    // Nearest requested floor; on a tie, the floor of the first request wins. -1 if none
+    int NearestRequestFloor(int floor, bool fCarOnly = false) const;
+
+    // Same queries keyed by floorDest of all active requests
+    int FirstDestAt(int floor) const;
+    int GetNumDestAt(int floor) const;
+    bool HasDestBelow(int floor) const;
+    // distance to the nearest floorDest; -1 if none
+    int NearestDestDistance(int floor) const;
+
+private:
+    // sorted list of ids threaded through one of the link arrays
+    struct Bucket
+    {
+        int head = -1;
+        int tail = -1;
+        int count = 0;
+    };
+    void Insert(Bucket &bucket, std::pmr::vector<int> &next, std::pmr::vector<int> &prev, int id);
+    void Erase(Bucket &bucket, std::pmr::vector<int> &next, std::pmr::vector<int> &prev, int id);
+    // keep the bit of a floor in step with its bucket
+    static void Mark(ECElevatorFloorRegister<NumFloors> &reg, const Bucket &bucket, int floor) { reg.Set(floor, bucket.count > 0); }
+    // word i of the requested floors mask
+    uint64_t GetCallWord(int i, bool fCarOnly) const
+    {
+        return regCarCalls.GetWord(i) | (fCarOnly ? 0 : regHallUp.GetWord(i) | regHallDown.GetWord(i));
+    }
+    // lowest floor above floor / highest floor below floor whose bit is set in word(i); -1 if none
+    template<class TWord> int ScanAbove(int floor, TWord word) const;
+    template<class TWord> int ScanBelow(int floor, TWord word) const;
+    int GetNumFloors() const { return NumFloors > 0 ? NumFloors : numFloors; }
+    bool IsValidFloor(int floor) const { return floor >= 1 && floor <= GetNumFloors(); }
+    int Count(int floor, bool fCarOnly) const;
+
+    int numFloors;
+    // buckets, indexed by floor (0 is not used)
+    ECElevatorFloorArray<Bucket, NumFloors> hallUp;
+    ECElevatorFloorArray<Bucket, NumFloors> hallDown;
+    ECElevatorFloorArray<Bucket, NumFloors> car;
+    ECElevatorFloorArray<Bucket, NumFloors> dest;
+    // floors with a non-empty bucket, one mask per kind
+    ECElevatorFloorRegister<NumFloors> regHallUp;
+    ECElevatorFloorRegister<NumFloors> regHallDown;
+    ECElevatorFloorRegister<NumFloors> regCarCalls;
+    ECElevatorFloorRegister<NumFloors> regDests;
+    // links: a request sits in one call bucket (hall or car) and one dest bucket
+    std::pmr::vector<int> callNext, callPrev;
+    std::pmr::vector<int> destNext, destPrev;
+    // active ids, and where each one sits in listActive (-1: not active)
+    std::pmr::vector<int> listActive;
+    std::pmr::vector<int> listActivePos;
+};
+
+// Number of floors given at run time
+typedef ECElevatorCallIndexT<0> ECElevatorCallIndex;
+
+#endif /* ECElevatorCallIndex_h */
@@ -0,0 +1,248 @@
+#ifndef ECElevatorDispatch_h
+#define ECElevatorDispatch_h
+
+#include "ECElevatorSim.h"
+
+//*****************************************************************************
+// Dispatch policies
+//
+// A policy answers the three questions the states ask about direction:
+// (i) Depart: the elevator is parked and there are requests (ECElevatorStateStop)
+// (ii) Continue: the elevator is moving and just got to a floor (ECElevatorStateMoving)
+// (iii) Leave: the elevator is done loading at a stop over (ECElevatorStopOver)
+// Each returns the direction to take; EC_ELEVATOR_STOPPED means park (for Depart:
+// stay parked). A full car only goes where its riders go.
+// Policies are plain types with static functions (templates over the simulation,
+// ECElevatorSimT of any size); ECElevatorSim.cpp instantiates the states for each
+// of them (add a new policy there and to EC_ELEVATOR_DISPATCH_TYPE).
+
+const char *ECElevatorGetDispatchName(EC_ELEVATOR_DISPATCH_TYPE type);
+// -1 if the name is unknown
+int ECElevatorFindDispatch(const char *name);
+
+//*****************************************************************************
+// Helpers shared by the policies
+
+// Direction of the nearest requested floor (ties: the first request); STOPPED if none
+template<class TSim>
+inline EC_ELEVATOR_DIR ECElevatorNearestDir(const TSim &elevator)
+{
+    int currFloor = elevator.GetCurrFloor();
+    int nearestFloor = elevator.GetCallIndex().NearestRequestFloor(currFloor, elevator.IsFull());
+    if( nearestFloor < 0 )
+    {
+        return EC_ELEVATOR_STOPPED;
+    }
+    return (nearestFloor > currFloor) ? EC_ELEVATOR_UP : EC_ELEVATOR_DOWN;
+}
+
+// Anything to do at this floor or beyond it going dir
+template<class TSim>
+inline bool ECElevatorHasReqAhead(const TSim &elevator, EC_ELEVATOR_DIR dir)
+{
+    const auto &calls = elevator.GetCallIndex();
+    int currFloor = elevator.GetCurrFloor();
+    bool fCarOnly = elevator.IsFull();
+    return (dir == EC_ELEVATOR_UP && calls.HasRequestAbove(currFloor, fCarOnly)) || (dir == EC_ELEVATOR_DOWN && calls.HasRequestBelow(currFloor, fCarOnly)) || elevator.FirstServableAt(currFloor) >= 0;
+}
+
+inline EC_ELEVATOR_DIR ECElevatorOppositeDir(EC_ELEVATOR_DIR dir)
+{
+    return (dir == EC_ELEVATOR_UP) ? EC_ELEVATOR_DOWN : (dir == EC_ELEVATOR_DOWN) ? EC_ELEVATOR_UP : EC_ELEVATOR_STOPPED;
+}
+
+// Keep going while there is something ahead, else turn around if there is something behind
+template<class TSim>
+inline EC_ELEVATOR_DIR ECElevatorLookDir(const TSim &elevator)
+{
+    EC_ELEVATOR_DIR currDir = elevator.GetCurrDir();
+    if( currDir == EC_ELEVATOR_STOPPED )
+    {
+        return ECElevatorNearestDir(elevator);
+    }
+    if( ECElevatorHasReqAhead(elevator, currDir) )
+    {
+        return currDir;
+    }
+    EC_ELEVATOR_DIR backDir = ECElevatorOppositeDir(currDir);
+    if( ECElevatorHasReqAhead(elevator, backDir) )
+    {
+        return backDir;
+    }
+    return ECElevatorNearestDir(elevator);
+}
+
+//*****************************************************************************
+// Original rules: head for the nearest request; keep moving while there is
+// something ahead; after a stop, decide by the destinations of all requests
+// (keep going up, or down if a destination is below; otherwise toward the
+// nearest destination, going up on ties)
+
+struct ECElevatorDefaultPolicy
+{
+    static const EC_ELEVATOR_DISPATCH_TYPE TYPE = EC_DISPATCH_DEFAULT;
+
+    template<class TSim>
+    static EC_ELEVATOR_DIR Depart(const TSim &elevator)
+    {
+        return ECElevatorNearestDir(elevator);
+    }
+    template<class TSim>
+    static EC_ELEVATOR_DIR Continue(const TSim &elevator)
+    {
+        return ECElevatorHasReqAhead(elevator, elevator.GetCurrDir()) ? elevator.GetCurrDir() : ECElevatorNearestDir(elevator);
+    }
+    template<class TSim>
+    static EC_ELEVATOR_DIR Leave(const TSim &elevator)
+    {
+        // Note: distances here are measured to the destination of each request, waiting or not
+        const auto &calls = elevator.GetCallIndex();
+        int currFloor = elevator.GetCurrFloor();
+        EC_ELEVATOR_DIR currDir = elevator.GetCurrDir();
+        if( calls.IsEmpty() )
+        {
+            return EC_ELEVATOR_STOPPED;
+        }
+        if( currDir == EC_ELEVATOR_DOWN && calls.HasDestBelow(currFloor) )
+        {
+            return EC_ELEVATOR_DOWN; // if elevator already going down and has a tie, then keep going down
+        }
+        if( currDir == EC_ELEVATOR_UP )
+        {
+            return EC_ELEVATOR_UP;
+        }
+        int distance = calls.NearestDestDistance(currFloor);
+        int numNearest = calls.GetNumDestAt(currFloor + distance) + (distance > 0 ? calls.GetNumDestAt(currFloor - distance) : 0);
+        if( numNearest > 1 && currDir != EC_ELEVATOR_DOWN )
+        {
+            return EC_ELEVATOR_UP; // if distance is the same, always go UP
+        }
+        // the first of the nearest requests decides
+        int above = calls.FirstDestAt(currFloor + distance);
+        int below = calls.FirstDestAt(currFloor - distance);
+        int first = (below >= 0 && (above < 0 || below < above)) ? below : above;
+        return (elevator.GetRequest(first).GetRequestedFloor() > currFloor) ? EC_ELEVATOR_UP : EC_ELEVATOR_DOWN;
+    }
+};
+
+//*****************************************************************************
+// LOOK: keep the direction while there are requests ahead, then turn around
+
+struct ECElevatorLookPolicy
+{
+    static const EC_ELEVATOR_DISPATCH_TYPE TYPE = EC_DISPATCH_LOOK;
+
+    template<class TSim>
+    static EC_ELEVATOR_DIR Depart(const TSim &elevator) { return ECElevatorNearestDir(elevator); }
+    template<class TSim>
+    static EC_ELEVATOR_DIR Continue(const TSim &elevator) { return ECElevatorLookDir(elevator); }
+    template<class TSim>
+    static EC_ELEVATOR_DIR Leave(const TSim &elevator)
+    {
+        return elevator.GetCallIndex().IsEmpty() ? EC_ELEVATOR_STOPPED : ECElevatorLookDir(elevator);
+    }
+};
+
+//*****************************************************************************
+// SCAN: while there are requests, sweep to the top or bottom floor before turning around
+
+struct ECElevatorScanPolicy
+{
+    static const EC_ELEVATOR_DISPATCH_TYPE TYPE = EC_DISPATCH_SCAN;
+
+    template<class TSim>
+    static EC_ELEVATOR_DIR Depart(const TSim &elevator) { return ECElevatorNearestDir(elevator); }
+    template<class TSim>
+    static EC_ELEVATOR_DIR Continue(const TSim &elevator)
+    {
+        EC_ELEVATOR_DIR currDir = elevator.GetCurrDir();
+        if( elevator.GetCallIndex().IsEmpty() )
+        {
+            return EC_ELEVATOR_STOPPED;
+        }
+        if( currDir == EC_ELEVATOR_STOPPED )
+        {
+            return ECElevatorNearestDir(elevator);
+        }
+        if( currDir == EC_ELEVATOR_UP && elevator.GetCurrFloor() >= elevator.GetNumFloors() )
+        {
+            return EC_ELEVATOR_DOWN;
+        }
+        if( currDir == EC_ELEVATOR_DOWN && elevator.GetCurrFloor() <= 1 )
+        {
+            return EC_ELEVATOR_UP;
+        }
+        return currDir;
+    }
+    template<class TSim>
+    static EC_ELEVATOR_DIR Leave(const TSim &elevator) { return Continue(elevator); }
+};
+
+//*****************************************************************************
+// Nearest first: whatever the direction, head for the nearest requested floor
+// (requests at this floor the car can't take are passed over as in LOOK)
+
+struct ECElevatorNearestPolicy
+{
+    static const EC_ELEVATOR_DISPATCH_TYPE TYPE = EC_DISPATCH_NEAREST;
+
+    template<class TSim>
+    static EC_ELEVATOR_DIR Depart(const TSim &elevator) { return ECElevatorNearestDir(elevator); }
+    template<class TSim>
+    static EC_ELEVATOR_DIR Continue(const TSim &elevator)
+    {
+        int nearestFloor = elevator.GetCallIndex().NearestRequestFloor(elevator.GetCurrFloor(), elevator.IsFull());
+        if( nearestFloor == elevator.GetCurrFloor() )
+        {
+            return ECElevatorLookDir(elevator);
+        }
+        return ECElevatorNearestDir(elevator);
+    }
+    template<class TSim>
+    static EC_ELEVATOR_DIR Leave(const TSim &elevator) { return Continue(elevator); }
+};
+
+//*****************************************************************************
+// Destination: when parked or leaving a stop, head for the request (first on ties)
+// whose destination is nearest: to its passenger if still waiting elsewhere, else to
+// the destination. In between stops, keep going as in LOOK (re-deciding at every
+// floor would swing back and forth as the nearest destination changes)
+
+struct ECElevatorDestinationPolicy
+{
+    static const EC_ELEVATOR_DISPATCH_TYPE TYPE = EC_DISPATCH_DESTINATION;
+
+    // (also Leave)
+    template<class TSim>
+    static EC_ELEVATOR_DIR Depart(const TSim &elevator)
+    {
+        const auto &calls = elevator.GetCallIndex();
+        int currFloor = elevator.GetCurrFloor();
+        if( elevator.IsFull() )
+        {
+            // riders only: car calls are bucketed by destination already
+            return ECElevatorNearestDir(elevator);
+        }
+        int distance = calls.NearestDestDistance(currFloor);
+        if( distance < 0 )
+        {
+            return EC_ELEVATOR_STOPPED;
+        }
+        int above = calls.FirstDestAt(currFloor + distance);
+        int below = calls.FirstDestAt(currFloor - distance);
+        int first = (below >= 0 && (above < 0 || below < above)) ? below : above;
+        const ECElevatorSimRequest &request = elevator.GetRequest(first);
+        int target = (request.GetRequestedFloor() != currFloor) ? request.GetRequestedFloor() : request.GetFloorDest();
+        if( target == currFloor )
+        {
+            return ECElevatorLookDir(elevator);
+        }
+        return (target > currFloor) ? EC_ELEVATOR_UP : EC_ELEVATOR_DOWN;
+    }
+    template<class TSim>
+    static EC_ELEVATOR_DIR Continue(const TSim &elevator) { return ECElevatorLookDir(elevator); }
+    template<class TSim>
+    static EC_ELEVATOR_DIR Leave(const TSim &elevator) { return Depart(elevator); }
+};
+
+#endif /* ECElevatorDispatch_h */
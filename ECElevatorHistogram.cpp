@@ -0,0 +1,116 @@
+#include "ECElevatorHistogram.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+ECElevatorHistogram :: ECElevatorHistogram() {
+  Clear();
+}
+
+void ECElevatorHistogram::Clear() {
+  memset(counts, 0, sizeof(counts));
+  count = 0;
+  sum = 0;
+  minValue = INT_MAX;
+  maxValue = 0;
+}
+
+// ********************** bucket layout ***********************
+// values [0, 32): bucket = value
+// values [2^e, 2^(e+1)), e >= 5: 32 buckets of width 2^(e-5), starting at (e-4)*32
+int ECElevatorHistogram::GetBucket(int value) {
+  if (value < SUB_COUNT) {
+    return value;
+  }
+  int e = 31 - __builtin_clz((unsigned)value);
+  return (e - SUB_BITS + 1) * SUB_COUNT + ((value >> (e - SUB_BITS)) - SUB_COUNT);
+}
+int ECElevatorHistogram::GetBucketTop(int bucket) {
+  if (bucket < SUB_COUNT) {
+    return bucket;
+  }
+  int e = bucket / SUB_COUNT + SUB_BITS - 1;
+  long long low = (long long)(bucket % SUB_COUNT + SUB_COUNT) << (e - SUB_BITS);
+  return (int)min(low + (1LL << (e - SUB_BITS)) - 1, (long long)INT_MAX);
+}
+
+void ECElevatorHistogram::Record(int value) {
+  value = max(value, 0);
+  ++counts[GetBucket(value)];
+  ++count;
+  sum += value;
+  minValue = min(minValue, value);
+  maxValue = max(maxValue, value);
+}
+
+void ECElevatorHistogram::Add(const ECElevatorHistogram &rhs) {
+  for (int b = 0; b < NUM_BUCKETS; ++b) {
+    counts[b] += rhs.counts[b];
+  }
+  count += rhs.count;
+  sum += rhs.sum;
+  minValue = min(minValue, rhs.minValue);
+  maxValue = max(maxValue, rhs.maxValue);
+}
+
+int ECElevatorHistogram::GetPercentile(double p) const {
+  if (count == 0) {
+    return 0;
+  }
+  long rank = max(1L, (long)ceil(p * count / 100.0));
+  long seen = 0;
+  for (int b = 0; b < NUM_BUCKETS; ++b) {
+    seen += counts[b];
+    if (seen >= rank) {
+      return min(GetBucketTop(b), maxValue);
+    }
+  }
+  return maxValue;
+}
+
+// ************************ checkpoints ***********************
+void ECElevatorHistogram::Save(ECElevatorBlobWriter &writer) const {
+  int numUsed = 0;
+  for (int b = 0; b < NUM_BUCKETS; ++b) {
+    numUsed += counts[b] != 0;
+  }
+  writer.WriteUnsigned(numUsed);
+  // (gap since the last bucket in use, count)
+  int last = -1;
+  for (int b = 0; b < NUM_BUCKETS; ++b) {
+    if (counts[b] != 0) {
+      writer.WriteUnsigned(b - last - 1);
+      writer.WriteUnsigned(counts[b]);
+      last = b;
+    }
+  }
+  writer.WriteSigned(sum);
+  writer.WriteSigned(minValue);
+  writer.WriteSigned(maxValue);
+}
+bool ECElevatorHistogram::Load(ECElevatorBlobReader &reader) {
+  Clear();
+  uint64_t numUsed = reader.ReadUnsigned();
+  int last = -1;
+  for (uint64_t i = 0; i < numUsed && !reader.IsBad(); ++i) {
+    uint64_t b = last + 1 + reader.ReadUnsigned();
+    if (b >= (uint64_t)NUM_BUCKETS) {
+      Clear();
+      return false;
+    }
+    counts[b] = reader.ReadUnsigned();
+    count += counts[b];
+    last = b;
+  }
+  sum = reader.ReadSigned();
+  minValue = reader.ReadSigned();
+  maxValue = reader.ReadSigned();
+  if (reader.IsBad()) {
+    Clear();
+    return false;
+  }
+  return true;
+}
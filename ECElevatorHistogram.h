@@ -0,0 +1,56 @@
+#ifndef ECElevatorHistogram_h
+#define ECElevatorHistogram_h
+
+#include <cstdint>
+#include "ECElevatorBlob.h"
+
+//*****************************************************************************
+// Histogram of non-negative times (in ticks) with log-sized buckets
+//
+// Values below 32 get a bucket each; above that, every power of two is split
+// into 32 buckets, so a percentile is off by at most 1/32 (~3%) of the value.
+// Recording is O(1) and the memory is fixed (no allocation); queries walk the
+// buckets, never the values, so they can be made at any time during a run.
+
+class ECElevatorHistogram
+{
+public:
+    ECElevatorHistogram();
+
+    // Add one value (negative values count as 0)
+    void Record(int value);
+
+    // Add all values of another histogram
+    void Add(const ECElevatorHistogram &rhs);
+
+    void Clear();
+
+    long GetCount() const { return count; }
+    double GetMean() const { return count > 0 ? (double)sum / count : 0.0; }
+    int GetMin() const { return count > 0 ? minValue : 0; }
+    int GetMax() const { return count > 0 ? maxValue : 0; }
+
+    // Checkpoints: only the buckets in use are written
+    void Save(ECElevatorBlobWriter &writer) const;
+    bool Load(ECElevatorBlobReader &reader);
+
+    // p-th percentile (nearest rank, 0 < p <= 100): the largest value of its bucket
+    // (never more than the max); 0 if empty
+    int GetPercentile(double p) const;
+
+private:
+    static const int SUB_BITS = 5;
+    static const int SUB_COUNT = 1 << SUB_BITS;
+    static const int NUM_BUCKETS = (32 - SUB_BITS) * SUB_COUNT;
+
+    static int GetBucket(int value);
+    static int GetBucketTop(int bucket);
+
+    int64_t counts[NUM_BUCKETS];
+    long count;
+    int64_t sum;
+    int minValue;
+    int maxValue;
+};
+
+#endif /* ECElevatorHistogram_h */
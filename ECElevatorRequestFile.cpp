@@ -0,0 +1,209 @@
+#include "ECElevatorRequestFile.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char binaryMagic[4] = {'E', 'C', 'R', 'Q'};
+static const size_t binaryHeaderSize = 8;
+// give pages back to the system every so often
+static const size_t releaseChunk = 16 << 20;
+
+ECElevatorRequestReader :: ECElevatorRequestReader() : pData(NULL), lenData(0), pos(0), posReleased(0), fBinary(false), fEmpty(false), fHasNext(false) {
+}
+ECElevatorRequestReader :: ~ECElevatorRequestReader() {
+  Close();
+}
+
+bool ECElevatorRequestReader::Open(const std::string &fileName) {
+  Close();
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return false;
+  }
+  lenData = st.st_size;
+  if (lenData == 0) {
+    // nothing to map
+    close(fd);
+    fEmpty = true;
+    return true;
+  }
+  void *p = mmap(NULL, lenData, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    lenData = 0;
+    return false;
+  }
+  pData = (const char *)p;
+  madvise(p, lenData, MADV_SEQUENTIAL);
+  fBinary = lenData >= binaryHeaderSize && memcmp(pData, binaryMagic, 4) == 0;
+  if (fBinary) {
+    // records of another layout can't be read
+    uint32_t sizeRecord;
+    memcpy(&sizeRecord, pData + 4, sizeof(sizeRecord));
+    if (sizeRecord != sizeof(ECElevatorRequestRecord)) {
+      Close();
+      return false;
+    }
+  }
+  pos = fBinary ? binaryHeaderSize : 0;
+  fHasNext = ParseNext();
+  return true;
+}
+
+void ECElevatorRequestReader::Close() {
+  if (pData != NULL) {
+    munmap((void *)pData, lenData);
+  }
+  pData = NULL;
+  lenData = pos = posReleased = 0;
+  fBinary = fEmpty = fHasNext = false;
+}
+
+int ECElevatorRequestReader::PeekTime() {
+  return fHasNext ? recNext.time : -1;
+}
+
+bool ECElevatorRequestReader::Next(int &time, int &floorSrc, int &floorDest) {
+  if (!fHasNext) {
+    return false;
+  }
+  time = recNext.time;
+  floorSrc = recNext.floorSrc;
+  floorDest = recNext.floorDest;
+  fHasNext = ParseNext();
+  ReleaseConsumed();
+  return true;
+}
+
+// parse the request at pos into recNext
+bool ECElevatorRequestReader::ParseNext() {
+  if (pData == NULL) {
+    return false;
+  }
+  if (fBinary) {
+    if (pos + sizeof(ECElevatorRequestRecord) > lenData) {
+      return false;
+    }
+    // (records with a negative time are skipped: that time means the end of the requests)
+    while (pos + sizeof(ECElevatorRequestRecord) <= lenData) {
+      memcpy(&recNext, pData + pos, sizeof(ECElevatorRequestRecord));
+      pos += sizeof(ECElevatorRequestRecord);
+      if (recNext.time >= 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+  while (pos < lenData) {
+    // skip comments, blank lines and malformed lines, and the ones that don't fit a
+    // record: a negative time (it means the end of the requests) or a floor past int16
+    int time, floorSrc, floorDest;
+    bool fOK = pData[pos] != '#' && ParseInt(time) && ParseInt(floorSrc) && ParseInt(floorDest) && ECElevatorFitsRequestRecord(time, floorSrc, floorDest);
+    while (pos < lenData && pData[pos] != '\n') {
+      ++pos;
+    }
+    ++pos;
+    if (fOK) {
+      recNext.time = time;
+      recNext.floorSrc = floorSrc;
+      recNext.floorDest = floorDest;
+      return true;
+    }
+  }
+  return false;
+}
+
+// parse an integer on the current line, skipping separators (spaces, commas) before it
+bool ECElevatorRequestReader::ParseInt(int &value) {
+  while (pos < lenData && (pData[pos] == ' ' || pData[pos] == '\t' || pData[pos] == ',' || pData[pos] == '\r')) {
+    ++pos;
+  }
+  bool fNeg = false;
+  if (pos < lenData && pData[pos] == '-') {
+    fNeg = true;
+    ++pos;
+  }
+  if (pos >= lenData || pData[pos] < '0' || pData[pos] > '9') {
+    return false;
+  }
+  // (numbers past int are malformed, not wrapped around)
+  long long v = 0;
+  while (pos < lenData && pData[pos] >= '0' && pData[pos] <= '9') {
+    v = min(v * 10 + (pData[pos] - '0'), (long long)INT_MAX + 1);
+    ++pos;
+  }
+  if (v > INT_MAX) {
+    return false;
+  }
+  value = fNeg ? -(int)v : (int)v;
+  return true;
+}
+
+// let the system drop pages that were parsed already, so a long replay doesn't pile them up
+void ECElevatorRequestReader::ReleaseConsumed() {
+  if (pos - posReleased < 2 * releaseChunk) {
+    return;
+  }
+  size_t pageSize = sysconf(_SC_PAGESIZE);
+  size_t end = ((pos - releaseChunk) / pageSize) * pageSize;
+  if (end > posReleased) {
+    madvise((void *)(pData + posReleased), end - posReleased, MADV_DONTNEED);
+    posReleased = end;
+  }
+}
+
+bool ECElevatorReadRequestFile(const std::string &fileName, std::vector<ECElevatorSimRequest> &listRequests) {
+  ECElevatorRequestReader reader;
+  if (!reader.Open(fileName)) {
+    return false;
+  }
+  int time, floorSrc, floorDest;
+  while (reader.Next(time, floorSrc, floorDest)) {
+    listRequests.push_back(ECElevatorSimRequest(time, floorSrc, floorDest));
+  }
+  return true;
+}
+
+bool ECElevatorFitsRequestRecord(int time, int floorSrc, int floorDest) {
+  return time >= 0 && floorSrc >= INT16_MIN && floorSrc <= INT16_MAX && floorDest >= INT16_MIN && floorDest <= INT16_MAX;
+}
+
+bool ECElevatorWriteRequestFile(const std::string &fileName, const std::vector<ECElevatorSimRequest> &listRequests, bool fBinary) {
+  // requests the reader would drop are turned down before anything is written
+  for (auto &request : listRequests) {
+    if (!ECElevatorFitsRequestRecord(request.GetTime(), request.GetFloorSrc(), request.GetFloorDest())) {
+      return false;
+    }
+  }
+  FILE *pFile = fopen(fileName.c_str(), fBinary ? "wb" : "w");
+  if (pFile == NULL) {
+    return false;
+  }
+  if (fBinary) {
+    uint32_t sizeRecord = sizeof(ECElevatorRequestRecord);
+    fwrite(binaryMagic, 1, 4, pFile);
+    fwrite(&sizeRecord, sizeof(sizeRecord), 1, pFile);
+    for (auto &request : listRequests) {
+      ECElevatorRequestRecord rec = {request.GetTime(), (int16_t)request.GetFloorSrc(), (int16_t)request.GetFloorDest()};
+      fwrite(&rec, sizeof(rec), 1, pFile);
+    }
+  }
+  else {
+    for (auto &request : listRequests) {
+      fprintf(pFile, "%d,%d,%d\n", request.GetTime(), request.GetFloorSrc(), request.GetFloorDest());
+    }
+  }
+  return fclose(pFile) == 0;
+}
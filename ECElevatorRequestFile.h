@@ -0,0 +1,76 @@
+#ifndef ECElevatorRequestFile_h
+#define ECElevatorRequestFile_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ECElevatorSim.h"
+
+//*****************************************************************************
+// Request files
+//
+// Two formats:
+// (i) text (CSV): one request per line: time,floorSrc,floorDest
+//     Blank lines and lines starting with '#' are skipped.
+// (ii) packed binary: the 8 byte header "ECRQ" + record size (uint32, = 8),
+//     then one record per request: time (int32), floorSrc (int16), floorDest (int16)
+// Requests should be sorted by time to be streamed into a simulation.
+// Times are never negative and floors fit in int16: the reader skips requests that
+// don't (as it skips malformed lines), and the writer won't write them.
+
+struct ECElevatorRequestRecord
+{
+    int32_t time;
+    int16_t floorSrc;
+    int16_t floorDest;
+};
+
+//*****************************************************************************
+// Reads requests of a file one at a time, straight out of a memory mapping:
+// nothing is parsed before it is asked for, and pages already read are given back
+
+class ECElevatorRequestReader : public ECElevatorRequestSource
+{
+public:
+    ECElevatorRequestReader();
+    ~ECElevatorRequestReader();
+
+    // Map the file. Return false if it can't be opened, or if it is binary and its
+    // record size isn't that of ECElevatorRequestRecord
+    bool Open(const std::string &fileName);
+    void Close();
+    bool IsOpen() const { return pData != NULL || fEmpty; }
+    bool IsBinary() const { return fBinary; }
+
+    // ECElevatorRequestSource
+    int PeekTime() override;
+    bool Next(int &time, int &floorSrc, int &floorDest) override;
+
+private:
+    bool ParseNext();
+    bool ParseInt(int &value);
+    void ReleaseConsumed();
+
+    const char *pData;
+    size_t lenData;
+    size_t pos;             // next byte to parse
+    size_t posReleased;     // bytes before this are given back to the system
+    bool fBinary;
+    bool fEmpty;
+    // next request (parsed ahead by one so that its time can be peeked)
+    bool fHasNext;
+    ECElevatorRequestRecord recNext;
+};
+
+// Read all requests of a file (either format) into listRequests (appended). Return false if the file can't be read
+bool ECElevatorReadRequestFile(const std::string &fileName, std::vector<ECElevatorSimRequest> &listRequests);
+
+// Does a request fit the format: time >= 0, floors in int16
+bool ECElevatorFitsRequestRecord(int time, int floorSrc, int floorDest);
+
+// Write requests to a file (text or binary). Return false on error, or if a request
+// doesn't fit the format (then nothing is written)
+bool ECElevatorWriteRequestFile(const std::string &fileName, const std::vector<ECElevatorSimRequest> &listRequests, bool fBinary = false);
+
+#endif /* ECElevatorRequestFile_h */
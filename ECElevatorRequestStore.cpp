@@ -0,0 +1,113 @@
+#include "ECElevatorRequestStore.h"
+
+using namespace std;
+
+// ***************** ECElevatorRequestRef CLASSES **************
+// *************************************************************
+int ECElevatorRequestRef::GetTime() const {
+  return store.GetTime(id);
+}
+int ECElevatorRequestRef::GetFloorSrc() const {
+  return store.GetFloorSrc(id);
+}
+int ECElevatorRequestRef::GetFloorDest() const {
+  return store.GetFloorDest(id);
+}
+bool ECElevatorRequestRef::IsFloorRequestDone() const {
+  return store.IsFloorRequestDone(id);
+}
+void ECElevatorRequestRef::SetFloorRequestDone(bool f) {
+  store.SetFloorRequestDone(id, f);
+}
+bool ECElevatorRequestRef::IsServiced() const {
+  return store.IsServiced(id);
+}
+void ECElevatorRequestRef::SetServiced(bool f) {
+  store.SetServiced(id, f);
+}
+int ECElevatorRequestRef::GetArriveTime() const {
+  return store.GetArriveTime(id);
+}
+void ECElevatorRequestRef::SetArriveTime(int t) {
+  store.SetArriveTime(id, t);
+}
+ECElevatorSimRequest ECElevatorRequestRef::ToRequest() const {
+  return store.Get(id);
+}
+
+// **************** ECElevatorRequestStore CLASSES *************
+// *************************************************************
+ECElevatorRequestStore :: ECElevatorRequestStore(const std::vector<ECElevatorSimRequest> &listRequests) : numRequests(0), firstLive(0) {
+  Reserve(listRequests.size());
+  for (auto &request : listRequests) {
+    Add(request);
+  }
+}
+
+int ECElevatorRequestStore::Add(const ECElevatorSimRequest &request) {
+  int id = numRequests++;
+  listTimes.push_back(request.GetTime());
+  listFloorSrcs.push_back(request.GetFloorSrc());
+  listFloorDests.push_back(request.GetFloorDest());
+  listArriveTimes.push_back(request.GetArriveTime());
+  if ((id & 63) == 0) {
+    bitsFloorReqDone.push_back(0);
+    bitsServiced.push_back(0);
+  }
+  SetFloorRequestDone(id, request.IsFloorRequestDone());
+  SetServiced(id, request.IsServiced());
+  return id;
+}
+
+void ECElevatorRequestStore::Reserve(int n) {
+  listTimes.reserve(n);
+  listFloorSrcs.reserve(n);
+  listFloorDests.reserve(n);
+  listArriveTimes.reserve(n);
+  bitsFloorReqDone.reserve((n + 63) / 64);
+  bitsServiced.reserve((n + 63) / 64);
+}
+
+void ECElevatorRequestStore::Clear() {
+  numRequests = 0;
+  firstLive = 0;
+  listTimes.clear();
+  listFloorSrcs.clear();
+  listFloorDests.clear();
+  listArriveTimes.clear();
+  bitsFloorReqDone.clear();
+  bitsServiced.clear();
+}
+
+ECElevatorSimRequest ECElevatorRequestStore::Get(int id) const {
+  ECElevatorSimRequest request(GetTime(id), GetFloorSrc(id), GetFloorDest(id));
+  request.SetFloorRequestDone(IsFloorRequestDone(id));
+  request.SetServiced(IsServiced(id));
+  request.SetArriveTime(GetArriveTime(id));
+  return request;
+}
+
+void ECElevatorRequestStore::WriteBack(std::vector<ECElevatorSimRequest> &listRequests) const {
+  for (int id = 0; id < numRequests && id < (int)listRequests.size(); ++id) {
+    listRequests[id].SetFloorRequestDone(IsFloorRequestDone(id));
+    listRequests[id].SetServiced(IsServiced(id));
+    listRequests[id].SetArriveTime(GetArriveTime(id));
+  }
+}
+
+int ECElevatorRequestStore::CountPending(int currentTime) const {
+  int numPending = 0;
+  for (unsigned int w = firstLive >> 6; w < bitsServiced.size(); ++w) {
+    uint64_t open = ~bitsServiced[w];
+    if (open == 0) {
+      // 64 serviced requests skipped without touching their times
+      continue;
+    }
+    int base = w << 6;
+    int end = std::min(base + 64, numRequests);
+    for (int id = base; id < end; ++id) {
+      numPending += (int)((open >> (id - base)) & 1) & (int)(listTimes[id] <= currentTime);
+    }
+  }
+  return numPending;
+}
@@ -0,0 +1,141 @@
+#ifndef ECElevatorRequestStore_h
+#define ECElevatorRequestStore_h
+
+#include <cstdint>
+#include <vector>
+#include "ECElevatorSim.h"
+
+class ECElevatorRequestStore;
+
+//*****************************************************************************
+// Handle to one request of an ECElevatorRequestStore, with the same accessors as
+// ECElevatorSimRequest (so code written against those works on either)
+
+class ECElevatorRequestRef
+{
+public:
+    ECElevatorRequestRef(ECElevatorRequestStore &storeIn, int idIn) : store(storeIn), id(idIn) {}
+    int GetId() const { return id; }
+
+    int GetTime() const;
+    int GetFloorSrc() const;
+    int GetFloorDest() const;
+    bool IsGoingUp() const { return GetFloorDest() >= GetFloorSrc(); }
+
+    bool IsFloorRequestDone() const;
+    void SetFloorRequestDone(bool f);
+
+    bool IsServiced() const;
+    void SetServiced(bool f);
+
+    // same stages as ECElevatorSimRequest::GetRequestedFloor
+    int GetRequestedFloor() const {
+        if( IsServiced() )  {
+            return -1;
+        }
+        else if( IsFloorRequestDone() )   {
+            return GetFloorDest();
+        }
+        else {
+            return GetFloorSrc();
+        }
+    }
+
+    int GetArriveTime() const;
+    void SetArriveTime(int t);
+
+    bool IsMaintenanceStart() const { return GetFloorSrc()==-1 && GetFloorDest()==-1; }
+    bool IsMaintenanceEnd() const { return GetFloorSrc()==0 && GetFloorDest()==0; }
+
+    // copy out as a plain request
+    ECElevatorSimRequest ToRequest() const;
+
+private:
+    ECElevatorRequestStore &store;
+    int id;
+};
+
+//*****************************************************************************
+// Requests stored column by column (struct of arrays)
+//
+// An ECElevatorSimRequest takes 20 bytes, of which a scan usually needs two or
+// three. Here each field has its own packed column: times and arrive times as
+// 32 bit, floors as 16 bit, and the two stage flags (fFloorReqDone, fServiced)
+// as bitsets, so a scan over one field reads nothing else.
+// Serviced requests retire from the scans: requests before GetFirstLive() are all
+// serviced, and the scans start there (rounded down to a word of flags), so their
+// cost follows the requests still in flight rather than the whole history. The
+// rows stay (ids are positions) for Get and WriteBack.
+
+class ECElevatorRequestStore
+{
+public:
+    ECElevatorRequestStore() : numRequests(0), firstLive(0) {}
+    explicit ECElevatorRequestStore(const std::vector<ECElevatorSimRequest> &listRequests);
+
+    // Append a request; return its id (position)
+    int Add(const ECElevatorSimRequest &request);
+    void Reserve(int n);
+    void Clear();
+    int GetSize() const { return numRequests; }
+
+    ECElevatorRequestRef operator[](int id) { return ECElevatorRequestRef(*this, id); }
+    ECElevatorSimRequest Get(int id) const;
+
+    // Copy the stage flags and arrive times back to the list the store was made from
+    void WriteBack(std::vector<ECElevatorSimRequest> &listRequests) const;
+
+    // Columns
+    int GetTime(int id) const { return listTimes[id]; }
+    int GetFloorSrc(int id) const { return listFloorSrcs[id]; }
+    int GetFloorDest(int id) const { return listFloorDests[id]; }
+    int GetArriveTime(int id) const { return listArriveTimes[id]; }
+    void SetArriveTime(int id, int t) { listArriveTimes[id] = t; }
+    bool IsFloorRequestDone(int id) const { return TestBit(bitsFloorReqDone, id); }
+    void SetFloorRequestDone(int id, bool f) { SetBit(bitsFloorReqDone, id, f); }
+    bool IsServiced(int id) const { return TestBit(bitsServiced, id); }
+    void SetServiced(int id, bool f)
+    {
+        SetBit(bitsServiced, id, f);
+        if( f )
+        {
+            while( firstLive < numRequests && IsServiced(firstLive) ) ++firstLive;
+        }
+        else if( id < firstLive )
+        {
+            firstLive = id;
+        }
+    }
+
+    // First request not serviced yet (GetSize() if none)
+    int GetFirstLive() const { return firstLive; }
+
+    const int32_t* GetTimes() const { return listTimes.data(); }
+    const int16_t* GetFloorSrcs() const { return listFloorSrcs.data(); }
+    const int16_t* GetFloorDests() const { return listFloorDests.data(); }
+    const uint64_t* GetFloorReqDoneBits() const { return bitsFloorReqDone.data(); }
+    const uint64_t* GetServicedBits() const { return bitsServiced.data(); }
+
+    // Number of requests made by currentTime and not serviced yet
+    // (what the states used to check for every request of the list, every tick)
+    int CountPending(int currentTime) const;
+
+private:
+    static bool TestBit(const std::vector<uint64_t> &bits, int id) { return (bits[id >> 6] >> (id & 63)) & 1; }
+    static void SetBit(std::vector<uint64_t> &bits, int id, bool f)
+    {
+        uint64_t mask = uint64_t(1) << (id & 63);
+        if( f ) bits[id >> 6] |= mask; else bits[id >> 6] &= ~mask;
+    }
+
+    int numRequests;
+    int firstLive;
+    std::vector<int32_t> listTimes;
+    std::vector<int16_t> listFloorSrcs;
+    std::vector<int16_t> listFloorDests;
+    std::vector<int32_t> listArriveTimes;
+    std::vector<uint64_t> bitsFloorReqDone;
+    std::vector<uint64_t> bitsServiced;
+};
+
+#endif /* ECElevatorRequestStore_h */
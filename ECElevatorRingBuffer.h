@@ -0,0 +1,126 @@
+#ifndef ECElevatorRingBuffer_h
+#define ECElevatorRingBuffer_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+//*****************************************************************************
+// Bounded lock-free queue over a preallocated ring
+//
+// Any number of threads may push and pop at the same time. Nothing is allocated
+// after construction and nobody blocks: TryPush fails when the ring is full,
+// TryPop fails when it is empty.
+// Each cell carries a sequence number telling whether it is ready to be written
+// (sequence == position) or to be read (sequence == position + 1).
+
+template<class T>
+class ECElevatorRingBuffer
+{
+public:
+    // capacity is rounded up to a power of two
+    explicit ECElevatorRingBuffer(size_t capacityIn) : capacity(RoundUp(capacityIn)), mask(capacity - 1), cells(new Cell[capacity]), enqueuePos(0), dequeuePos(0)
+    {
+        for(size_t i=0; i<capacity; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    ECElevatorRingBuffer(const ECElevatorRingBuffer &) = delete;
+    ECElevatorRingBuffer& operator=(const ECElevatorRingBuffer &) = delete;
+
+    bool TryPush(const T &item)
+    {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while(true)
+        {
+            Cell &cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if( diff == 0 )
+            {
+                if( enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) )
+                {
+                    cell.data = item;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if( diff < 0 )
+            {
+                // full
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool TryPop(T &item)
+    {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while(true)
+        {
+            Cell &cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if( diff == 0 )
+            {
+                if( dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) )
+                {
+                    item = cell.data;
+                    cell.sequence.store(pos + capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if( diff < 0 )
+            {
+                // empty
+                return false;
+            }
+            else
+            {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t GetCapacity() const { return capacity; }
+
+    // Approximate number of items queued (exact if no push/pop is going on)
+    size_t GetSize() const
+    {
+        size_t tail = enqueuePos.load(std::memory_order_acquire);
+        size_t head = dequeuePos.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    static size_t RoundUp(size_t n)
+    {
+        size_t c = 2;
+        while( c < n )
+        {
+            c <<= 1;
+        }
+        return c;
+    }
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    const size_t capacity;
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    // producers and consumers work on different cache lines
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) std::atomic<size_t> dequeuePos;
+};
+
+#endif /* ECElevatorRingBuffer_h */
@@ -1,252 +1,135 @@
 #include "ECElevatorSim.h"
+#include "ECElevatorDispatch.h"
+#include <cstring>
 
 using namespace std;
 
-bool ECElevatorState::CurrReq(const ECElevatorSimRequest& request, int currentTime) {
-  return !request.IsServiced() && request.GetTime() <= currentTime;
-}
-
 // *************** ECElevatorStateStop CLASSES ****************
 // ************************************************************
-void ECElevatorStateStop::Redirect(ECElevatorSim &elevator) {
-  std::vector<ECElevatorSimRequest>& requests = elevator.GetListRequests();
+template<class TPolicy, int NumFloors>
+void ECElevatorStateStopT<TPolicy, NumFloors>::Redirect(ECElevatorSimT<NumFloors> &elevator) {
+  const ECElevatorCallIndexT<NumFloors>& calls = elevator.GetCallIndex();
   int currFloor = elevator.GetCurrFloor();
-  int currTime = elevator.GetCurrentTime();
-
-  bool foundRequest = false;
-
-  for(auto& request : requests) {
-    // checks to see if any requests are from where the elevator is parked; NO LOAD TIME
-    if (CurrReq(request, currTime)) {
-      if (request.GetFloorSrc() == currFloor && !request.IsFloorRequestDone()) {
-        // passenger is at current floor and hasn't boarded yet
-        request.SetFloorRequestDone(true);
-        std::cout << "Passenger boarded at floor " << currFloor << " at time " << currTime << std::endl;
-        elevator.SetCurrInElevator(1);
-        elevator.SetState(new ECElevatorStopOver());
-        return;
-      }
-      if (request.GetFloorDest() == currFloor && request.IsFloorRequestDone() && !request.IsServiced()) {
-        // passenger is at destination floor
-        request.SetServiced(true);
-        request.SetArriveTime(currTime);
-        std::cout << "Passenger arrived at floor " << currFloor << " at time " << currTime << std::endl;
-        elevator.SetCurrInElevator(-1);
-        elevator.SetState(new ECElevatorStopOver());
-        return;
-      }
-      foundRequest = true;
+
+  // checks to see if any requests are from where the elevator is parked; NO LOAD TIME
+  int first = elevator.FirstServableAt(currFloor);
+  if (first >= 0) {
+    if (!elevator.GetRequest(first).IsFloorRequestDone()) {
+      // passenger is at current floor and hasn't boarded yet
+      elevator.BoardRequest(first);
     }
-  }
-  if(foundRequest) {
-    // move elevator;
+    else {
+      // passenger is at destination floor
+      elevator.ArriveRequest(first);
+    }
+    elevator.SetState(elevator.GetStateStopOver());
     return;
   }
-  else {
+  if (calls.IsEmpty()) {
     elevator.SetCurrDir(EC_ELEVATOR_STOPPED);
   }
+  // otherwise: move elevator
 }
-void ECElevatorStateStop::Move(ECElevatorSim &elevator) {
-  std::vector<ECElevatorSimRequest>& requests = elevator.GetListRequests();
-  int currFloor = elevator.GetCurrFloor();
-  int nearestDistance = elevator.GetNumFloors() + 1;
-  EC_ELEVATOR_DIR newDirection = EC_ELEVATOR_STOPPED;
-
-  for (auto &request : requests) {
-    if (CurrReq(request, elevator.GetCurrentTime())) {
-      int distance = abs(request.GetRequestedFloor() - currFloor);
-      if (distance < nearestDistance) {
-        nearestDistance = distance;
-        newDirection = (request.GetRequestedFloor() > currFloor) ? EC_ELEVATOR_UP : EC_ELEVATOR_DOWN; // if requested floor is > than curr, go up, else, go down
-      } 
-      else if (distance == nearestDistance && newDirection == EC_ELEVATOR_STOPPED) {
-        newDirection = EC_ELEVATOR_UP; // if distance is the same, always go UP
-      }
-    }
-  }
-  if (newDirection != EC_ELEVATOR_STOPPED) {
-    elevator.SetCurrDir(newDirection);
-    elevator.SetState(new ECElevatorStateMoving());
+template<class TPolicy, int NumFloors>
+void ECElevatorStateStopT<TPolicy, NumFloors>::Move(ECElevatorSimT<NumFloors> &elevator) {
+  EC_ELEVATOR_DIR newDir = TPolicy::Depart(elevator);
+  if (newDir != EC_ELEVATOR_STOPPED) {
+    elevator.SetCurrDir(newDir);
+    elevator.SetState(elevator.GetStateMoving());
   }
 }
 
 
 // *************** ECElevatorStateMoving CLASSES **************
 // ************************************************************
-
-// ********************* helper functions *********************
-bool ECElevatorStateMoving::PassOff(const ECElevatorSimRequest& request, int currFloor) {
-  return !request.IsServiced() && request.IsFloorRequestDone() && request.GetFloorDest() == currFloor;
-}
-bool ECElevatorStateMoving::PassOn(const ECElevatorSimRequest& request, int currFloor, int currTime) {
-  return !request.IsFloorRequestDone() && request.GetTime() <= currTime && request.GetFloorSrc() == currFloor;
-}
-bool ECElevatorStateMoving::ReqCurrDirection(ECElevatorSim &elevator) {
-  std::vector<ECElevatorSimRequest>& requests = elevator.GetListRequests();
-  int currFloor = elevator.GetCurrFloor();
-  EC_ELEVATOR_DIR currDir = elevator.GetCurrDir();
-  for (auto &request : requests) {
-    if (CurrReq(request, elevator.GetCurrentTime())) {
-      int requestedFloor = request.IsFloorRequestDone() ? request.GetFloorDest() : request.GetFloorSrc();
-      if ((currDir == EC_ELEVATOR_UP && requestedFloor > currFloor) || (currDir == EC_ELEVATOR_DOWN && requestedFloor < currFloor) || (requestedFloor == currFloor)) {
-        return true;
-      }
-    }
-  }
-  return false;
-}
-bool ECElevatorStateMoving::NearestReq(ECElevatorSim &elevator, EC_ELEVATOR_DIR &newDir) {
-  std::vector<ECElevatorSimRequest>& requests = elevator.GetListRequests();
-  int currFloor = elevator.GetCurrFloor();
-  int nearestDistance = elevator.GetNumFloors() + 1;
-  bool hasPendingRequests = false;
-
-  for (auto &request : requests) {
-    if (CurrReq(request, elevator.GetCurrentTime())) {
-      int requestedFloor = request.IsFloorRequestDone() ? request.GetFloorDest() : request.GetFloorSrc();
-      int distance = abs(requestedFloor - currFloor);
-
-      if (distance < nearestDistance) {
-        nearestDistance = distance;
-        newDir = (requestedFloor > currFloor) ? EC_ELEVATOR_UP : EC_ELEVATOR_DOWN;
-        hasPendingRequests = true;
-      }
-    }
+template<class TPolicy, int NumFloors>
+void ECElevatorStateMovingT<TPolicy, NumFloors>::Redirect(ECElevatorSimT<NumFloors> &elevator) {
+  int first = elevator.FirstServableAt(elevator.GetCurrFloor());
+  if (first < 0) {
+    return;
   }
-  return hasPendingRequests;
-}
-
-// ******************** main two functions ********************
-void ECElevatorStateMoving::Redirect(ECElevatorSim &elevator) { 
-  std::vector<ECElevatorSimRequest>& requests = elevator.GetListRequests();
-  int currFloor = elevator.GetCurrFloor();
-  int currTime = elevator.GetCurrentTime();
-  for (auto &request : requests) {
-    // passengers getting OFF
-    if (PassOff(request, currFloor)) {
-      elevator.SetState(new ECElevatorStopOver());
-      return;
-    }
-    // passengers getting ON
-    if (PassOn(request, currFloor, currTime)) {
-      request.SetFloorRequestDone(true);
-      std::cout << "Passenger boarded at floor " << currFloor << " at time " << elevator.GetCurrentTime() << std::endl;
-      elevator.SetCurrInElevator(1);
-      elevator.SetState(new ECElevatorStopOver());
-      return;
-    }
+  // passengers getting ON; passengers getting OFF are let out by the stop over
+  if (!elevator.GetRequest(first).IsFloorRequestDone()) {
+    elevator.BoardRequest(first);
   }
+  elevator.SetState(elevator.GetStateStopOver());
 }
-void ECElevatorStateMoving::Move(ECElevatorSim &elevator) {
-  if (elevator.GetCurrentState() != this) {
-    // State has changed, do not update direction
-    return;
-  }
-  if (!ReqCurrDirection(elevator)) {
-    EC_ELEVATOR_DIR newDir;
-    if (NearestReq(elevator, newDir)) {
-      elevator.SetCurrDir(newDir);
-    } else {
-      elevator.SetCurrDir(EC_ELEVATOR_STOPPED);
-      elevator.SetState(new ECElevatorStateStop());
-      std::cout << "Elevator has stopped due to no pending requests." << std::endl;
-    }
+template<class TPolicy, int NumFloors>
+void ECElevatorStateMovingT<TPolicy, NumFloors>::Move(ECElevatorSimT<NumFloors> &elevator) {
+  EC_ELEVATOR_DIR newDir = TPolicy::Continue(elevator);
+  if (newDir != EC_ELEVATOR_STOPPED) {
+    elevator.SetCurrDir(newDir);
+  } else {
+    elevator.SetCurrDir(EC_ELEVATOR_STOPPED);
+    elevator.SetState(elevator.GetStateStop());
+    EC_TRACE(elevator.GetTraceSink(), EC_TRACE_STATE, elevator.GetCurrentTime(), EC_TRACE_EV_STOPPED, elevator.GetCurrFloor(), 0);
   }
 }
 
 
 // **************** ECElevatorStopOver CLASSES ****************
 // ************************************************************
-
-// ********************* helper functions *********************
-bool ECElevatorStopOver::GoUp(int distance, int nearestDistance, EC_ELEVATOR_DIR currDir) {
-  return distance == nearestDistance && currDir != EC_ELEVATOR_DOWN;
-}
-bool ECElevatorStopOver::GoDown(int dest, int floor, EC_ELEVATOR_DIR dir) {
-  return dest < floor && dir == EC_ELEVATOR_DOWN;
-}
-bool ECElevatorStopOver::NewDist(int dist, int nearestDist) {
-  return dist < nearestDist;
+template<class TPolicy, int NumFloors>
+void ECElevatorStopOverT<TPolicy, NumFloors>::Enter(ECElevatorSimT<NumFloors> &elevator) {
+  elevator.SetLoadTime(1);
 }
-EC_ELEVATOR_DIR ECElevatorStopOver::ternary(int requested, int floor, EC_ELEVATOR_DIR dir) {
-  return (requested > floor || dir == EC_ELEVATOR_UP) ? EC_ELEVATOR_UP : EC_ELEVATOR_DOWN;
-}
-
-// ******************** main two functions ********************
-void ECElevatorStopOver::Redirect(ECElevatorSim &elevator) {
-  if (loadTime > 0) {
+template<class TPolicy, int NumFloors>
+void ECElevatorStopOverT<TPolicy, NumFloors>::Redirect(ECElevatorSimT<NumFloors> &elevator) {
+  if (elevator.GetLoadTime() > 0) {
     // do not change direction yet; loading/unloading is not complete
     return;
   }
   // after loading/unloading, check if we need to change direction
-  std::vector<ECElevatorSimRequest>& requests = elevator.GetListRequests();
-  int currFloor = elevator.GetCurrFloor();
-  EC_ELEVATOR_DIR newDirection = EC_ELEVATOR_STOPPED;
-  int nearestDistance = elevator.GetNumFloors() + 1;
-
-  for (auto &request : requests) {
-    if (CurrReq(request, elevator.GetCurrentTime())) {
-      int requestedFloor = request.IsFloorRequestDone() ? request.GetFloorDest() : request.GetFloorSrc();
-      if (GoDown(request.GetFloorDest(), elevator.GetCurrFloor(), elevator.GetCurrDir())) { // if elevator already going down and has a tie, then keep going down
-        newDirection = EC_ELEVATOR_DOWN;
-        break;
-      }
-      int distance = abs(request.GetFloorDest() - currFloor);
-      if (NewDist(distance, nearestDistance)) {
-        nearestDistance = distance;
-        newDirection = ternary(requestedFloor, currFloor, elevator.GetCurrDir());
-      }
-      else if (GoUp(distance, nearestDistance, elevator.GetCurrDir())) {
-        newDirection = EC_ELEVATOR_UP; // if distance is the same, always go UP
-      }
-    }
-  }
+  EC_ELEVATOR_DIR newDirection = TPolicy::Leave(elevator);
   if (newDirection != EC_ELEVATOR_STOPPED) {
     elevator.SetCurrDir(newDirection);
-    elevator.SetState(new ECElevatorStateMoving());
+    elevator.SetState(elevator.GetStateMoving());
   }
   else {
     elevator.SetCurrDir(EC_ELEVATOR_STOPPED);
-    elevator.SetState(new ECElevatorStateStop());
+    elevator.SetState(elevator.GetStateStop());
   }
 }
-void ECElevatorStopOver::Move(ECElevatorSim &elevator) {
-  std::vector<ECElevatorSimRequest>& requests = elevator.GetListRequests();
+template<class TPolicy, int NumFloors>
+void ECElevatorStopOverT<TPolicy, NumFloors>::Move(ECElevatorSimT<NumFloors> &elevator) {
+  const ECElevatorCallIndexT<NumFloors>& calls = elevator.GetCallIndex();
   int currFloor = elevator.GetCurrFloor();
 
-  EC_ELEVATOR_DIR newDirection = EC_ELEVATOR_STOPPED;
+  int loadTime = elevator.GetLoadTime();
   //Passengers leave elevator
   if(loadTime == 1){
-    for (auto &request : requests) {
-      if (!request.IsServiced() && request.IsFloorRequestDone() && request.GetFloorDest() == currFloor) {
-        request.SetServiced(true);
-        request.SetArriveTime(elevator.GetCurrentTime());
-        std::cout << "Passenger arrived at floor " << currFloor << " at time " << elevator.GetCurrentTime() << std::endl;
-        elevator.SetCurrInElevator(-1);
-      }
+    while (calls.GetNumCarCalls(currFloor) > 0) {
+      elevator.ArriveRequest(calls.FirstCarCall(currFloor));
     }
-    // Passengers board elevator
-    for (auto &request : requests) {
-      if (!request.IsFloorRequestDone() && request.GetTime() <= elevator.GetCurrentTime() && request.GetFloorSrc() == currFloor) {
-        // Passengers can board regardless of direction
-        request.SetFloorRequestDone(true);
-        std::cout << "Passenger boarded at floor " << currFloor << " at time " << elevator.GetCurrentTime() << std::endl;
-        elevator.SetCurrInElevator(1);
+    // Passengers board elevator, in the order they made requests, as long as there is room
+    // Passengers can board regardless of direction (unless boarding by direction)
+    while (true) {
+      int up = calls.FirstHallCall(currFloor, true);
+      int down = calls.FirstHallCall(currFloor, false);
+      up = (up >= 0 && elevator.CanBoard(up)) ? up : -1;
+      down = (down >= 0 && elevator.CanBoard(down)) ? down : -1;
+      if (up < 0 && down < 0) {
+        break;
       }
+      elevator.BoardRequest((down < 0 || (up >= 0 && up < down)) ? up : down);
     }
   }
   if(loadTime > 0) {
-    loadTime--;
+    elevator.SetLoadTime(loadTime - 1);
   }
 }
 
 
 
-void ECElevatorMaintenance::Redirect(ECElevatorSim &elevator) {}
-void ECElevatorMaintenance::Move(ECElevatorSim &elevator) {}
+template<int NumFloors>
+void ECElevatorMaintenanceT<NumFloors>::Redirect(ECElevatorSimT<NumFloors> &) {}
+template<int NumFloors>
+void ECElevatorMaintenanceT<NumFloors>::Move(ECElevatorSimT<NumFloors> &) {}
 
-void ECElevatorStateStop::moveElevator(ECElevatorSim &elevator) {}
-void ECElevatorStateMoving::moveElevator(ECElevatorSim &elevator) {
+template<class TPolicy, int NumFloors>
+void ECElevatorStateStopT<TPolicy, NumFloors>::moveElevator(ECElevatorSimT<NumFloors> &) {}
+template<class TPolicy, int NumFloors>
+void ECElevatorStateMovingT<TPolicy, NumFloors>::moveElevator(ECElevatorSimT<NumFloors> &elevator) {
   int currFloor = elevator.GetCurrFloor();
   EC_ELEVATOR_DIR currDir = elevator.GetCurrDir();
   int numFloors = elevator.GetNumFloors();
@@ -257,94 +140,666 @@ void ECElevatorStateMoving::moveElevator(ECElevatorSim &elevator) {
     elevator.SetCurrFloor(currFloor - 1);
   }
 }
-void ECElevatorStopOver::moveElevator(ECElevatorSim &elevator) {}
-void ECElevatorMaintenance::moveElevator(ECElevatorSim &elevator) {}
+template<class TPolicy, int NumFloors>
+void ECElevatorStopOverT<TPolicy, NumFloors>::moveElevator(ECElevatorSimT<NumFloors> &) {}
+template<int NumFloors>
+void ECElevatorMaintenanceT<NumFloors>::moveElevator(ECElevatorSimT<NumFloors> &) {}
+
 
+// ********************* dispatch policies ********************
+// ************************************************************
+static const char *dispatchNames[EC_DISPATCH_NUM_TYPES] = {"default", "look", "scan", "nearest", "destination"};
+
+const char *ECElevatorGetDispatchName(EC_ELEVATOR_DISPATCH_TYPE type) {
+  return dispatchNames[type];
+}
+int ECElevatorFindDispatch(const char *name) {
+  for (int t = 0; t < EC_DISPATCH_NUM_TYPES; ++t) {
+    if (strcmp(name, dispatchNames[t]) == 0) {
+      return t;
+    }
+  }
+  return -1;
+}
 
+// the states of each policy; they hold no data, so every simulation shares them
+// (one set per policy and simulation size)
+template<int NumFloors>
+struct ECElevatorStateSet {
+  ECElevatorStateT<NumFloors> *pStop;
+  ECElevatorStateT<NumFloors> *pMoving;
+  ECElevatorStateT<NumFloors> *pStopOver;
+};
+template<class TPolicy, int NumFloors>
+static ECElevatorStateSet<NumFloors> GetPolicyStates() {
+  static ECElevatorStateStopT<TPolicy, NumFloors> stateStop;
+  static ECElevatorStateMovingT<TPolicy, NumFloors> stateMoving;
+  static ECElevatorStopOverT<TPolicy, NumFloors> stateStopOver;
+  return {&stateStop, &stateMoving, &stateStopOver};
+}
+template<int NumFloors>
+static ECElevatorStateSet<NumFloors> GetDispatchStates(EC_ELEVATOR_DISPATCH_TYPE type) {
+  switch (type) {
+  case EC_DISPATCH_LOOK:
+    return GetPolicyStates<ECElevatorLookPolicy, NumFloors>();
+  case EC_DISPATCH_SCAN:
+    return GetPolicyStates<ECElevatorScanPolicy, NumFloors>();
+  case EC_DISPATCH_NEAREST:
+    return GetPolicyStates<ECElevatorNearestPolicy, NumFloors>();
+  case EC_DISPATCH_DESTINATION:
+    return GetPolicyStates<ECElevatorDestinationPolicy, NumFloors>();
+  default:
+    return GetPolicyStates<ECElevatorDefaultPolicy, NumFloors>();
+  }
+}
+template<int NumFloors>
+static ECElevatorStateT<NumFloors>* GetMaintenanceState() {
+  static ECElevatorMaintenanceT<NumFloors> stateMaintenance;
+  return &stateMaintenance;
+}
 
 // ******************* ECElevatorSim CLASSES ******************* 
 // *************************************************************
-ECElevatorSim :: ECElevatorSim(int numFloors, std::vector<ECElevatorSimRequest> &listRequests) : numFloors(numFloors), listRequests(listRequests), currFloor(1), currDir(EC_ELEVATOR_STOPPED), currTime(0) {
-  currentState = new ECElevatorStateStop();
+template<int NumFloors>
+ECElevatorSimT<NumFloors> :: ECElevatorSimT(int numFloors, std::vector<ECElevatorSimRequest> &listRequests, bool fAssignAll, std::pmr::memory_resource *pResource) : numFloors(numFloors), pResource(pResource), pSource(NULL), numServicedOwned(0), listRequests(listRequests), listBoardTimes(listRequests.size(), -1, pResource), currFloor(1), currDir(EC_ELEVATOR_STOPPED), currentState(NULL), currTime(0), currInElevator(0), capacity(0), fBoardByDirection(false), callIndex(numFloors, listRequests.size(), pResource), fAssignAll(fAssignAll), listActivation(pResource), nextActivation(0), numSkippedTicks(0), loadTime(0), pTraceSink(NULL), baseInjected(0) {
+  SetDispatch(EC_DISPATCH_DEFAULT);
+  currentState = pStateStop;
+  BuildActivationOrder();
+}
+template<int NumFloors>
+ECElevatorSimT<NumFloors> :: ECElevatorSimT(int numFloors, ECElevatorRequestSource &source, std::pmr::memory_resource *pResource) : numFloors(numFloors), pResource(pResource), pSource(&source), numServicedOwned(0), listRequests(listOwnedRequests), listBoardTimes(pResource), currFloor(1), currDir(EC_ELEVATOR_STOPPED), currentState(NULL), currTime(0), currInElevator(0), capacity(0), fBoardByDirection(false), callIndex(numFloors, 0, pResource), fAssignAll(true), listActivation(pResource), nextActivation(0), numSkippedTicks(0), loadTime(0), pTraceSink(NULL), baseInjected(0) {
+  SetDispatch(EC_DISPATCH_DEFAULT);
+  currentState = pStateStop;
 }
-ECElevatorSim :: ~ECElevatorSim() {
-  delete currentState;
+template<int NumFloors>
+ECElevatorSimT<NumFloors> :: ~ECElevatorSimT() {
 }
 
-void ECElevatorSim::Simulate(int lenSim) {
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::Simulate(int lenSim) {
   while (currTime < lenSim) {
-    std::cout << "Time: " << currTime << ", Floor: " << GetCurrFloor() << ", Dir: " << GetCurrDir() << std::endl;
-    // Process new requests at currentTime
-    for (auto &request : listRequests) {
-      if (request.GetTime() == currTime) {
-        // Request is made at this time
-        std::cout << "New request: From floor " << request.GetFloorSrc() << " to floor " << request.GetFloorDest() << std::endl;
-      }
+    SkipIdleTicks(lenSim);
+    if (currTime >= lenSim) {
+      break;
     }
+    AdvanceOneTick();
+  }
+}
+
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::AdvanceOneTick() {
+    EC_TRACE(pTraceSink, EC_TRACE_TICK, currTime, EC_TRACE_EV_TICK, currFloor, currDir);
+    // Process new requests at currentTime
+    DrainInjectedRequests();
+    ActivateDueRequests();
+
+    // Let the current state handle redirection and movement
     currentState->Redirect(*this);
     currentState->Move(*this);
     currentState->moveElevator(*this);
 
     ++currTime;
+}
+
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::BuildActivationOrder() {
+  // requests are activated in time order (ties: in list order)
+  listActivation.resize(fAssignAll ? listRequests.size() : 0);
+  for (unsigned int i = 0; i < listActivation.size(); ++i) {
+    listActivation[i] = i;
   }
+  // (sort on time and id: same order as a stable sort, without its scratch buffer)
+  std::sort(listActivation.begin(), listActivation.end(), [this](int a, int b) {
+    int timeA = listRequests[a].GetTime(), timeB = listRequests[b].GetTime();
+    return timeA < timeB || (timeA == timeB && a < b);
+  });
 }
 
-// **** new added shit
-void ECElevatorSim::AdvanceOneTick() {
-    // Similar to what happens for one iteration in Simulate()
-    std::cout << "Time: " << currTime << ", Floor: " << GetCurrFloor() << ", Dir: " << GetCurrDir() << std::endl;
-    for (auto &request : listRequests) {
-        if (request.GetTime() == currTime) {
-            std::cout << "New request: From floor " << request.GetFloorSrc() << " to floor " << request.GetFloorDest() << std::endl;
-        }
+template<int NumFloors>
+bool ECElevatorSimT<NumFloors>::ActivateRequest(int id) {
+  return callIndex.Activate(id, GetRequest(id));
+}
+template<int NumFloors>
+bool ECElevatorSimT<NumFloors>::AssignRequest(int id) {
+  return ActivateRequest(id);
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::ActivateDueRequests() {
+  if (pSource != NULL) {
+    ReadDueRequests();
+    return;
+  }
+  // future requests stay behind the cursor until their time comes
+  while (nextActivation < listActivation.size() && listRequests[listActivation[nextActivation]].GetTime() <= currTime) {
+    int id = listActivation[nextActivation++];
+    EC_TRACE(pTraceSink, EC_TRACE_STATE, currTime, EC_TRACE_EV_NEW_REQUEST, listRequests[id].GetFloorSrc(), listRequests[id].GetFloorDest());
+    ActivateRequest(id);
+  }
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::ReadDueRequests() {
+  CompactRequests();
+  int time, floorSrc, floorDest;
+  while (pSource->PeekTime() >= 0 && pSource->PeekTime() <= currTime && pSource->Next(time, floorSrc, floorDest)) {
+    if (floorSrc < 1 || floorSrc > GetNumFloors() || floorDest < 1 || floorDest > GetNumFloors()) {
+      continue;
     }
+    AddRequest(time, floorSrc, floorDest);
+  }
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::DrainInjectedRequests() {
+  if (pInjected == NULL) {
+    return;
+  }
+  // at most one ring's worth: producers that keep pushing don't hold up the tick
+  ECElevatorInjectedRequest injected;
+  if (pSource != NULL) {
+    // streaming: the list is the simulation's own, compacted as it goes
+    for (size_t i = 0; i < pInjected->GetCapacity() && pInjected->TryPop(injected); ++i) {
+      AddRequest(currTime, injected.floorSrc, injected.floorDest);
+    }
+    return;
+  }
+  // into a free slot; when all are in play the rest wait in the queue
+  int slot = 0;
+  while (pFreeSlots->GetSize() > 0 && pInjected->TryPop(injected)) {
+    pFreeSlots->TryPop(slot);
+    int id = baseInjected + slot;
+    listInjected[slot] = ECElevatorSimRequest(currTime, injected.floorSrc, injected.floorDest);
+    listBoardTimes[id] = -1;
+    EC_TRACE(pTraceSink, EC_TRACE_STATE, currTime, EC_TRACE_EV_NEW_REQUEST, injected.floorSrc, injected.floorDest);
+    ActivateRequest(id);
+  }
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::AddRequest(int time, int floorSrc, int floorDest) {
+  listRequests.push_back(ECElevatorSimRequest(time, floorSrc, floorDest));
+  listBoardTimes.push_back(-1);
+  EC_TRACE(pTraceSink, EC_TRACE_STATE, currTime, EC_TRACE_EV_NEW_REQUEST, floorSrc, floorDest);
+  ActivateRequest(listRequests.size() - 1);
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::CompactRequests() {
+  if (numServicedOwned < 1024 || 2 * numServicedOwned < listOwnedRequests.size()) {
+    return;
+  }
+  // ids are positions in the list: keep the requests in play, renumbered in order
+  // (a request left waiting for long doesn't hold the ones after it)
+  unsigned int numLive = 0;
+  for (unsigned int i = 0; i < listOwnedRequests.size(); ++i) {
+    if (!listOwnedRequests[i].IsServiced()) {
+      listOwnedRequests[numLive] = listOwnedRequests[i];
+      listBoardTimes[numLive] = listBoardTimes[i];
+      ++numLive;
+    }
+  }
+  listOwnedRequests.erase(listOwnedRequests.begin() + numLive, listOwnedRequests.end());
+  listBoardTimes.erase(listBoardTimes.begin() + numLive, listBoardTimes.end());
+  numServicedOwned = 0;
+  callIndex.Reset();
+  for (unsigned int i = 0; i < numLive; ++i) {
+    callIndex.Activate(i, listOwnedRequests[i]);
+  }
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SkipIdleTicks(int lenSim) {
+  if (currentState->GetType() != EC_ELEVATOR_STATE_STOP || !callIndex.IsEmpty()) {
+    return;
+  }
+  if (pInjected != NULL && pInjected->GetSize() > 0) {
+    return;
+  }
+  // a parked elevator just stays stopped until the next request is made
+  int nextTime = GetNextRequestTime();
+  if (nextTime >= 0 && nextTime <= currTime) {
+    return;
+  }
+  int skipTo = (nextTime < 0 || nextTime > lenSim) ? lenSim : nextTime;
+  if (skipTo > currTime) {
+    EC_TRACE(pTraceSink, EC_TRACE_STATE, currTime, EC_TRACE_EV_IDLE, currFloor, skipTo);
+    SetCurrDir(EC_ELEVATOR_STOPPED);
+    numSkippedTicks += skipTo - currTime;
+    currTime = skipTo;
+  }
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::BoardRequest(int id) {
+  ECElevatorSimRequest &request = GetRequest(id);
+  request.SetFloorRequestDone(true);
+  callIndex.Board(id, request);
+  listBoardTimes[id] = currTime;
+  histWait.Record(currTime - request.GetTime());
+  EC_TRACE(pTraceSink, EC_TRACE_PASSENGER, currTime, EC_TRACE_EV_BOARD, currFloor, id);
+  SetCurrInElevator(1);
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::ArriveRequest(int id) {
+  ECElevatorSimRequest &request = GetRequest(id);
+  request.SetServiced(true);
+  request.SetArriveTime(currTime);
+  callIndex.Arrive(id, request);
+  histRide.Record(currTime - listBoardTimes[id]);
+  histJourney.Record(currTime - request.GetTime());
+  if (pSource != NULL) {
+    ++numServicedOwned;
+  }
+  EC_TRACE(pTraceSink, EC_TRACE_PASSENGER, currTime, EC_TRACE_EV_ARRIVE, currFloor, id);
+  if (handlerArrive) {
+    handlerArrive(request);
+  }
+  if (!listInjected.empty() && id >= baseInjected) {
+    // the slot is taken again once the ones freed before it are
+    pFreeSlots->TryPush(id - baseInjected);
+  }
+  SetCurrInElevator(-1);
+}
 
-    // Let the current state handle redirection and movement
-    currentState->Redirect(*this);
-    currentState->Move(*this);
-    currentState->moveElevator(*this);
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::EnableInjection(int capacity) {
+  pInjected.reset(new ECElevatorRingBuffer<ECElevatorInjectedRequest>(capacity));
+  if (pSource != NULL) {
+    return;
+  }
+  // one slot per queued request, with ids past the end of the list: every array the
+  // tick path writes for them is sized here
+  int numSlots = pInjected->GetCapacity();
+  baseInjected = listRequests.size();
+  listInjected.assign(numSlots, ECElevatorSimRequest(0, 0, 0));
+  pFreeSlots.reset(new ECElevatorRingBuffer<int>(numSlots));
+  for (int slot = 0; slot < numSlots; ++slot) {
+    pFreeSlots->TryPush(slot);
+  }
+  listBoardTimes.resize(baseInjected + numSlots, -1);
+  callIndex.Reserve(baseInjected + numSlots);
+}
+template<int NumFloors>
+bool ECElevatorSimT<NumFloors>::InjectRequest(int floorSrc, int floorDest) {
+  if (pInjected == NULL || floorSrc < 1 || floorSrc > numFloors || floorDest < 1 || floorDest > numFloors || floorSrc == floorDest) {
+    return false;
+  }
+  ECElevatorInjectedRequest injected;
+  injected.floorSrc = floorSrc;
+  injected.floorDest = floorDest;
+  return pInjected->TryPush(injected);
+}
 
-    ++currTime;
+template<int NumFloors>
+int ECElevatorSimT<NumFloors>::GetBoardTime(int id) const {
+  return listBoardTimes[id];
 }
-// **** END
 
-int ECElevatorSim::GetNumFloors() const {
-  return numFloors;
+template<int NumFloors>
+int ECElevatorSimT<NumFloors>::GetNextRequestTime() const {
+  if (pSource != NULL) {
+    return pSource->PeekTime();
+  }
+  if (nextActivation >= listActivation.size()) {
+    return -1;
+  }
+  return listRequests[listActivation[nextActivation]].GetTime();
+}
+template<int NumFloors>
+int ECElevatorSimT<NumFloors>::GetNumSkippedTicks() const {
+  return numSkippedTicks;
+}
+template<int NumFloors>
+const ECElevatorHistogram& ECElevatorSimT<NumFloors>::GetWaitHistogram() const {
+  return histWait;
+}
+template<int NumFloors>
+const ECElevatorHistogram& ECElevatorSimT<NumFloors>::GetRideHistogram() const {
+  return histRide;
+}
+template<int NumFloors>
+const ECElevatorHistogram& ECElevatorSimT<NumFloors>::GetJourneyHistogram() const {
+  return histJourney;
+}
+
+// ************************ checkpoints ***********************
+static const char CHECKPOINT_MAGIC[4] = {'E', 'C', 'C', 'K'};
+static const uint8_t CHECKPOINT_VERSION = 1;
+// request stage bits
+static const uint8_t CHECKPOINT_BOARDED = 1;
+static const uint8_t CHECKPOINT_SERVICED = 2;
+static const uint8_t CHECKPOINT_IN_PLAY = 4;
+
+template<int NumFloors>
+uint64_t ECElevatorSimT<NumFloors>::HashRequests(int numRequests) const {
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  for (int id = 0; id < numRequests; ++id) {
+    const ECElevatorSimRequest &request = listRequests[id];
+    for (int v : {request.GetTime(), request.GetFloorSrc(), request.GetFloorDest()}) {
+      hash = (hash ^ (uint32_t)v) * 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+template<int NumFloors>
+bool ECElevatorSimT<NumFloors>::SaveCheckpoint(std::vector<uint8_t> &blob) const {
+  blob.clear();
+  if (pSource != NULL || !listInjected.empty()) {
+    return false;
+  }
+  ECElevatorBlobWriter writer(blob);
+  writer.WriteBytes(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+  writer.WriteByte(CHECKPOINT_VERSION);
+  writer.WriteUnsigned(GetNumFloors());
+  writer.WriteUnsigned(listRequests.size());
+  uint64_t hash = HashRequests(listRequests.size());
+  writer.WriteBytes(&hash, sizeof(hash));
+  for (int v : {currTime, currFloor, (int)currDir, (int)currentState->GetType(), loadTime, currInElevator, numSkippedTicks}) {
+    writer.WriteSigned(v);
+  }
+
+  // only requests that are made and not left alone: (gap since the last one, stage, times)
+  int numTouched = 0;
+  for (unsigned int id = 0; id < listRequests.size(); ++id) {
+    const ECElevatorSimRequest &request = listRequests[id];
+    numTouched += request.IsFloorRequestDone() || request.IsServiced() || callIndex.IsActive(id);
+  }
+  writer.WriteUnsigned(numTouched);
+  int last = -1;
+  for (unsigned int id = 0; id < listRequests.size(); ++id) {
+    const ECElevatorSimRequest &request = listRequests[id];
+    uint8_t stage = (request.IsFloorRequestDone() ? CHECKPOINT_BOARDED : 0) | (request.IsServiced() ? CHECKPOINT_SERVICED : 0) | (callIndex.IsActive(id) ? CHECKPOINT_IN_PLAY : 0);
+    if (stage == 0) {
+      continue;
+    }
+    writer.WriteUnsigned(id - last - 1);
+    writer.WriteByte(stage);
+    // times relative to the previous step: small numbers
+    if (stage & CHECKPOINT_BOARDED) {
+      writer.WriteSigned(listBoardTimes[id] - request.GetTime());
+    }
+    if (stage & CHECKPOINT_SERVICED) {
+      writer.WriteSigned(request.GetArriveTime() - listBoardTimes[id]);
+    }
+    last = id;
+  }
+  histWait.Save(writer);
+  histRide.Save(writer);
+  histJourney.Save(writer);
+  return true;
+}
+
+template<int NumFloors>
+bool ECElevatorSimT<NumFloors>::RestoreCheckpoint(const std::vector<uint8_t> &blob) {
+  if (pSource != NULL || !listInjected.empty()) {
+    return false;
+  }
+  ECElevatorBlobReader reader(blob.data(), blob.size());
+  char magic[sizeof(CHECKPOINT_MAGIC)];
+  if (!reader.ReadBytes(magic, sizeof(magic)) || memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 || reader.ReadByte() != CHECKPOINT_VERSION) {
+    return false;
+  }
+  uint64_t numFloorsSaved = reader.ReadUnsigned();
+  uint64_t numRequestsSaved = reader.ReadUnsigned();
+  uint64_t hash = 0;
+  reader.ReadBytes(&hash, sizeof(hash));
+  if (reader.IsBad() || numFloorsSaved != (uint64_t)GetNumFloors() || numRequestsSaved > listRequests.size() || hash != HashRequests(numRequestsSaved)) {
+    return false;
+  }
+  int values[7];
+  for (int &v : values) {
+    v = reader.ReadSigned();
+  }
+  // (time, floor, direction, state, ...): the floor indexes the call index's buckets
+  if (values[1] < 1 || values[1] > GetNumFloors() || values[2] < EC_ELEVATOR_STOPPED || values[2] > EC_ELEVATOR_DOWN || values[3] < EC_ELEVATOR_STATE_STOP || values[3] > EC_ELEVATOR_STATE_MAINTENANCE) {
+    return false;
+  }
+
+  // read everything before changing anything
+  struct Touched {
+    int id;
+    uint8_t stage;
+    int timeBoard;
+    int timeArrive;
+  };
+  std::vector<Touched> listTouched;
+  uint64_t numTouched = reader.ReadUnsigned();
+  int last = -1;
+  for (uint64_t i = 0; i < numTouched && !reader.IsBad(); ++i) {
+    uint64_t id = last + 1 + reader.ReadUnsigned();
+    if (id >= numRequestsSaved) {
+      return false;
+    }
+    Touched touched = {(int)id, reader.ReadByte(), -1, -1};
+    if (touched.stage & CHECKPOINT_BOARDED) {
+      touched.timeBoard = listRequests[id].GetTime() + reader.ReadSigned();
+    }
+    if (touched.stage & CHECKPOINT_SERVICED) {
+      touched.timeArrive = touched.timeBoard + reader.ReadSigned();
+    }
+    listTouched.push_back(touched);
+    last = id;
+  }
+  ECElevatorHistogram histWaitSaved, histRideSaved, histJourneySaved;
+  if (!histWaitSaved.Load(reader) || !histRideSaved.Load(reader) || !histJourneySaved.Load(reader) || !reader.IsAtEnd()) {
+    return false;
+  }
+
+  // requests
+  for (auto &request : listRequests) {
+    request.SetFloorRequestDone(false);
+    request.SetServiced(false);
+    request.SetArriveTime(-1);
+  }
+  listBoardTimes.assign(listRequests.size(), -1);
+  callIndex.Reset();
+  callIndex.Reserve(listRequests.size());
+  for (auto &touched : listTouched) {
+    ECElevatorSimRequest &request = listRequests[touched.id];
+    request.SetFloorRequestDone((touched.stage & CHECKPOINT_BOARDED) != 0);
+    request.SetServiced((touched.stage & CHECKPOINT_SERVICED) != 0);
+    request.SetArriveTime(touched.timeArrive);
+    listBoardTimes[touched.id] = touched.timeBoard;
+    if (touched.stage & CHECKPOINT_IN_PLAY) {
+      callIndex.Activate(touched.id, request);
+    }
+  }
+  histWait = histWaitSaved;
+  histRide = histRideSaved;
+  histJourney = histJourneySaved;
+
+  // elevator
+  currTime = values[0];
+  currFloor = values[1];
+  currDir = (EC_ELEVATOR_DIR)values[2];
+  ECElevatorStateT<NumFloors> *states[] = {pStateStop, pStateMoving, pStateStopOver, pStateMaintenance};
+  currentState = states[values[3]];
+  loadTime = values[4];
+  currInElevator = values[5];
+  numSkippedTicks = values[6];
+
+  // requests made before now are active (requests new to the list come in play now)
+  if (listActivation.size() != (fAssignAll ? listRequests.size() : 0)) {
+    BuildActivationOrder();
+  }
+  nextActivation = 0;
+  while (nextActivation < listActivation.size() && listRequests[listActivation[nextActivation]].GetTime() < currTime) {
+    int id = listActivation[nextActivation++];
+    if (id >= (int)numRequestsSaved) {
+      ActivateRequest(id);
+    }
+  }
+  return true;
+}
+template<int NumFloors>
+int ECElevatorSimT<NumFloors>::GetNumFloors() const {
+  return NumFloors > 0 ? NumFloors : numFloors;
 }
-int ECElevatorSim::GetCurrFloor() const {
+template<int NumFloors>
+int ECElevatorSimT<NumFloors>::GetCurrFloor() const {
   return currFloor;
 }
-void ECElevatorSim::SetCurrFloor(int f) {
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SetCurrFloor(int f) {
   currFloor = f; // could check if f is within the allowable range
 }
-EC_ELEVATOR_DIR ECElevatorSim::GetCurrDir() const {
+template<int NumFloors>
+EC_ELEVATOR_DIR ECElevatorSimT<NumFloors>::GetCurrDir() const {
   return currDir;
 }
-void ECElevatorSim::SetCurrDir(EC_ELEVATOR_DIR dir) {
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SetCurrDir(EC_ELEVATOR_DIR dir) {
   currDir = dir;
 }
-std::vector<ECElevatorSimRequest>& ECElevatorSim::GetListRequests() {
+template<int NumFloors>
+std::vector<ECElevatorSimRequest>& ECElevatorSimT<NumFloors>::GetListRequests() {
   return listRequests;
 }
-ECElevatorState* ECElevatorSim::GetCurrentState() {
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SetArriveHandler(const std::function<void(const ECElevatorSimRequest &)> &handler) {
+  handlerArrive = handler;
+}
+template<int NumFloors>
+ECElevatorSimRequest& ECElevatorSimT<NumFloors>::GetRequest(int id) {
+  return (!listInjected.empty() && id >= baseInjected) ? listInjected[id - baseInjected] : listRequests[id];
+}
+template<int NumFloors>
+const ECElevatorSimRequest& ECElevatorSimT<NumFloors>::GetRequest(int id) const {
+  return (!listInjected.empty() && id >= baseInjected) ? listInjected[id - baseInjected] : listRequests[id];
+}
+template<int NumFloors>
+int ECElevatorSimT<NumFloors>::GetNumRequests() const {
+  return listRequests.size();
+}
+template<int NumFloors>
+const ECElevatorCallIndexT<NumFloors>& ECElevatorSimT<NumFloors>::GetCallIndex() const {
+  return callIndex;
+}
+template<int NumFloors>
+ECElevatorStateT<NumFloors>* ECElevatorSimT<NumFloors>::GetCurrentState() {
+  return currentState;
+}
+template<int NumFloors>
+const ECElevatorStateT<NumFloors>* ECElevatorSimT<NumFloors>::GetCurrentState() const {
   return currentState;
 }
-void ECElevatorSim::SetState(ECElevatorState *newState) {
-  if(currentState != nullptr){
-    delete currentState;
+template<int NumFloors>
+ECElevatorStateT<NumFloors>* ECElevatorSimT<NumFloors>::GetStateStop() {
+  return pStateStop;
+}
+template<int NumFloors>
+ECElevatorStateT<NumFloors>* ECElevatorSimT<NumFloors>::GetStateMoving() {
+  return pStateMoving;
+}
+template<int NumFloors>
+ECElevatorStateT<NumFloors>* ECElevatorSimT<NumFloors>::GetStateStopOver() {
+  return pStateStopOver;
+}
+template<int NumFloors>
+ECElevatorStateT<NumFloors>* ECElevatorSimT<NumFloors>::GetStateMaintenance() {
+  return pStateMaintenance;
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SetDispatch(EC_ELEVATOR_DISPATCH_TYPE type) {
+  ECElevatorStateSet<NumFloors> states = GetDispatchStates<NumFloors>(type);
+  dispatch = type;
+  pStateStop = states.pStop;
+  pStateMoving = states.pMoving;
+  pStateStopOver = states.pStopOver;
+  pStateMaintenance = GetMaintenanceState<NumFloors>();
+  // same state, new rules (without entering it again)
+  if (currentState != NULL) {
+    ECElevatorStateT<NumFloors> *byType[] = {pStateStop, pStateMoving, pStateStopOver, pStateMaintenance};
+    currentState = byType[currentState->GetType()];
   }
+}
+template<int NumFloors>
+EC_ELEVATOR_DISPATCH_TYPE ECElevatorSimT<NumFloors>::GetDispatch() const {
+  return dispatch;
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SetState(ECElevatorStateT<NumFloors> *newState) {
   currentState = newState;
-  std::cout << "State changed to: " << typeid(*currentState).name() << std::endl;
+  currentState->Enter(*this);
+  EC_TRACE(pTraceSink, EC_TRACE_STATE, currTime, EC_TRACE_EV_STATE, currFloor, currentState->GetType());
 }
-int ECElevatorSim::GetCurrentTime() const { 
+template<int NumFloors>
+int ECElevatorSimT<NumFloors>::GetCurrentTime() const { 
   return currTime; 
 }
-void ECElevatorSim::SetCurrentTime(int t) { 
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SetCurrentTime(int t) { 
   currTime = t; 
 }
-int ECElevatorSim::GetCurrInElevator() const {
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SetTraceSink(ECElevatorTraceSink *pSink) {
+  pTraceSink = pSink;
+}
+template<int NumFloors>
+ECElevatorTraceSink* ECElevatorSimT<NumFloors>::GetTraceSink() const {
+  return pTraceSink;
+}
+template<int NumFloors>
+int ECElevatorSimT<NumFloors>::GetLoadTime() const {
+  return loadTime;
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SetLoadTime(int t) {
+  loadTime = t;
+}
+template<int NumFloors>
+int ECElevatorSimT<NumFloors>::GetCurrInElevator() const {
   return currInElevator;
 }
-void ECElevatorSim::SetCurrInElevator(int x) {
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SetCurrInElevator(int x) {
   currInElevator += x;
-}
\ No newline at end of file
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SetCapacity(int c) {
+  capacity = c;
+}
+template<int NumFloors>
+int ECElevatorSimT<NumFloors>::GetCapacity() const {
+  return capacity;
+}
+template<int NumFloors>
+bool ECElevatorSimT<NumFloors>::IsFull() const {
+  return capacity > 0 && currInElevator >= capacity;
+}
+template<int NumFloors>
+void ECElevatorSimT<NumFloors>::SetBoardByDirection(bool f) {
+  fBoardByDirection = f;
+}
+template<int NumFloors>
+bool ECElevatorSimT<NumFloors>::IsBoardByDirection() const {
+  return fBoardByDirection;
+}
+template<int NumFloors>
+bool ECElevatorSimT<NumFloors>::CanBoard(int id) const {
+  if (IsFull()) {
+    return false;
+  }
+  if (!fBoardByDirection || currDir == EC_ELEVATOR_STOPPED || GetRequest(id).IsGoingUp() == (currDir == EC_ELEVATOR_UP)) {
+    return true;
+  }
+  // going the other way: only if the car turns around here (nothing ahead, nobody here going its way)
+  bool fUp = currDir == EC_ELEVATOR_UP;
+  bool fAhead = fUp ? callIndex.HasRequestAbove(currFloor) : callIndex.HasRequestBelow(currFloor);
+  return !fAhead && callIndex.FirstHallCall(currFloor, fUp) < 0;
+}
+template<int NumFloors>
+int ECElevatorSimT<NumFloors>::FirstServableAt(int floor) const {
+  int first = callIndex.FirstCarCall(floor);
+  for (bool goingUp : {true, false}) {
+    // passengers waiting the same way all can get in or none can
+    int id = callIndex.FirstHallCall(floor, goingUp);
+    if (id >= 0 && (first < 0 || id < first) && CanBoard(id)) {
+      first = id;
+    }
+  }
+  return first;
+}
+
+// the sizes with a fixed number of floors (see ECElevatorSimT)
+template class ECElevatorSimT<0>;
+template class ECElevatorSimT<8>;
+template class ECElevatorSimT<16>;
+template class ECElevatorSimT<32>;
+template class ECElevatorSimT<64>;
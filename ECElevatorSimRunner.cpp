@@ -0,0 +1,89 @@
+#include "ECElevatorSimRunner.h"
+
+using namespace std;
+
+void ECElevatorTakeSnapshot(const ECElevatorSim &sim, ECElevatorSnapshot &snapshot) {
+  snapshot.time = sim.GetCurrentTime();
+  snapshot.currFloor = sim.GetCurrFloor();
+  snapshot.currDir = sim.GetCurrDir();
+  snapshot.state = sim.GetCurrentState()->GetType();
+  snapshot.numInElevator = sim.GetCurrInElevator();
+  snapshot.numServiced = sim.GetJourneyHistogram().GetCount();
+  std::fill(snapshot.listWaitingUp.begin(), snapshot.listWaitingUp.end(), 0);
+  std::fill(snapshot.listWaitingDown.begin(), snapshot.listWaitingDown.end(), 0);
+  for (int id : sim.GetCallIndex().GetActiveRequests()) {
+    const ECElevatorSimRequest &request = sim.GetRequest(id);
+    if (request.IsFloorRequestDone()) {
+      continue;
+    }
+    if (request.IsGoingUp()) {
+      ++snapshot.listWaitingUp[request.GetFloorSrc() - 1];
+    }
+    else {
+      ++snapshot.listWaitingDown[request.GetFloorSrc() - 1];
+    }
+  }
+}
+
+// ************************************************************
+ECElevatorSimRunner :: ECElevatorSimRunner(ECElevatorSim &sim, int lenSim, std::chrono::microseconds tickPeriod) : sim(sim), lenSim(lenSim), tickPeriod(tickPeriod), snapshots(ECElevatorSnapshot(sim.GetNumFloors())), fPaused(false), fStop(false), fDone(false) {
+  // the view has something to draw before the first tick
+  ECElevatorTakeSnapshot(sim, snapshots.GetBack());
+  snapshots.GetBack().fDone = sim.GetCurrentTime() >= lenSim;
+  snapshots.Publish();
+}
+ECElevatorSimRunner :: ~ECElevatorSimRunner() {
+  Stop();
+}
+
+void ECElevatorSimRunner::Start() {
+  if (!thread.joinable()) {
+    fStop = false;
+    thread = std::thread(&ECElevatorSimRunner::Run, this);
+  }
+}
+
+void ECElevatorSimRunner::Stop() {
+  fStop = true;
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+void ECElevatorSimRunner::SetPaused(bool f) {
+  fPaused = f;
+}
+
+bool ECElevatorSimRunner::IsPaused() const {
+  return fPaused;
+}
+
+bool ECElevatorSimRunner::IsDone() const {
+  return fDone;
+}
+
+const ECElevatorSnapshot& ECElevatorSimRunner::GetSnapshot() {
+  snapshots.Update();
+  return snapshots.GetFront();
+}
+
+void ECElevatorSimRunner::Run() {
+  auto tmNext = std::chrono::steady_clock::now();
+  while (!fStop && sim.GetCurrentTime() < lenSim) {
+    if (fPaused) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      tmNext = std::chrono::steady_clock::now();
+      continue;
+    }
+    sim.AdvanceOneTick();
+    ECElevatorSnapshot &snapshot = snapshots.GetBack();
+    ECElevatorTakeSnapshot(sim, snapshot);
+    snapshot.fDone = sim.GetCurrentTime() >= lenSim;
+    snapshots.Publish();
+    if (tickPeriod.count() > 0) {
+      tmNext += tickPeriod;
+      std::this_thread::sleep_until(tmNext);
+    }
+  }
+  fDone = sim.GetCurrentTime() >= lenSim;
+}
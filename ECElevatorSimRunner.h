@@ -0,0 +1,77 @@
+#ifndef ECElevatorSimRunner_h
+#define ECElevatorSimRunner_h
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "ECElevatorSim.h"
+#include "ECElevatorTripleBuffer.h"
+
+//*****************************************************************************
+// What a view needs to draw the elevator at one tick
+
+struct ECElevatorSnapshot
+{
+    int time = 0;                   // ticks run so far
+    int currFloor = 1;
+    EC_ELEVATOR_DIR currDir = EC_ELEVATOR_STOPPED;
+    EC_ELEVATOR_STATE_TYPE state = EC_ELEVATOR_STATE_STOP;
+    int numInElevator = 0;
+    long numServiced = 0;
+    bool fDone = false;             // the run is over
+    // passengers waiting at each floor (index: floor - 1)
+    std::vector<int> listWaitingUp;
+    std::vector<int> listWaitingDown;
+
+    explicit ECElevatorSnapshot(int numFloors = 0) : listWaitingUp(numFloors, 0), listWaitingDown(numFloors, 0) {}
+};
+
+// Fill a snapshot (sized for the simulation's floors) from the simulation as it is now;
+// walks the requests in play only, and allocates nothing
+void ECElevatorTakeSnapshot(const ECElevatorSim &sim, ECElevatorSnapshot &snapshot);
+
+//*****************************************************************************
+// Simulation on its own thread
+//
+// The thread advances the simulation one tick at a time and publishes a snapshot
+// after each tick through a triple buffer; a view (one reader thread) draws the
+// latest snapshot at its own frame rate. Neither waits for the other: a slow view
+// skips snapshots, a fast one draws the same snapshot again.
+// Once started, only the runner's thread touches the simulation; other threads
+// talk to it through InjectRequest (see ECElevatorSim) and the snapshots.
+
+class ECElevatorSimRunner
+{
+public:
+    // lenSim: ticks to run; tickPeriod: wall time of a tick (0: as fast as possible)
+    ECElevatorSimRunner(ECElevatorSim &sim, int lenSim, std::chrono::microseconds tickPeriod = std::chrono::microseconds(0));
+    // stops the thread
+    ~ECElevatorSimRunner();
+
+    void Start();
+    // Stop the thread and wait for it; the simulation is left at the last tick run
+    void Stop();
+
+    // While paused the thread sleeps between checks and runs no tick
+    void SetPaused(bool f);
+    bool IsPaused() const;
+    bool IsDone() const;
+
+    // Reader: the newest snapshot published (the same one again if nothing new)
+    const ECElevatorSnapshot& GetSnapshot();
+
+private:
+    void Run();
+
+    ECElevatorSim &sim;
+    int lenSim;
+    std::chrono::microseconds tickPeriod;
+    ECElevatorTripleBuffer<ECElevatorSnapshot> snapshots;
+    std::atomic<bool> fPaused;
+    std::atomic<bool> fStop;
+    std::atomic<bool> fDone;
+    std::thread thread;
+};
+
+#endif /* ECElevatorSimRunner_h */
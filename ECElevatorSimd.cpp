@@ -0,0 +1,343 @@
+#include "ECElevatorSimd.h"
+#include <climits>
+#include <cstdlib>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define EC_ELEVATOR_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// ************************ partial results ********************
+// *************************************************************
+
+// what one vector lane (or the scalar loop) found among the requests it saw
+struct ECScanLane
+{
+    int bestDist = INT_MAX;     // nearest requested floor: distance, first id
+    int bestId = -1;
+    int bestDestDist = INT_MAX; // nearest floorDest: distance, how many, first id
+    int numBestDest = 0;
+    int firstBestDest = -1;
+};
+
+struct ECScanFlags
+{
+    int numActive = 0;
+    bool fAbove = false;
+    bool fBelow = false;
+    bool fAt = false;
+    bool fDestBelow = false;
+};
+
+// scalar scan of requests [begin, end) into one lane
+static void ScanScalar(const ECElevatorRequestStore &store, int currFloor, int currTime, int begin, int end, ECScanLane &lane, ECScanFlags &flags) {
+  const int32_t *times = store.GetTimes();
+  const int16_t *srcs = store.GetFloorSrcs();
+  const int16_t *dests = store.GetFloorDests();
+  for (int id = begin; id < end; ++id) {
+    if (store.IsServiced(id) || times[id] > currTime) {
+      continue;
+    }
+    ++flags.numActive;
+    int requested = store.IsFloorRequestDone(id) ? dests[id] : srcs[id];
+    flags.fAbove |= requested > currFloor;
+    flags.fBelow |= requested < currFloor;
+    flags.fAt |= requested == currFloor;
+    int dist = abs(requested - currFloor);
+    if (dist < lane.bestDist) {
+      lane.bestDist = dist;
+      lane.bestId = id;
+    }
+    int destDist = abs(dests[id] - currFloor);
+    flags.fDestBelow |= dests[id] < currFloor;
+    if (destDist < lane.bestDestDist) {
+      lane.bestDestDist = destDist;
+      lane.numBestDest = 1;
+      lane.firstBestDest = id;
+    }
+    else if (destDist == lane.bestDestDist) {
+      ++lane.numBestDest;
+    }
+  }
+}
+
+#ifdef EC_ELEVATOR_SIMD_X86
+
+// ************************ AVX2: 8 requests *******************
+// *************************************************************
+__attribute__((target("avx2")))
+static int ScanAvx2(const ECElevatorRequestStore &store, int begin, int currFloor, int currTime, ECScanLane lanes[8], ECScanFlags &flags) {
+  const int32_t *times = store.GetTimes();
+  const int16_t *srcs = store.GetFloorSrcs();
+  const int16_t *dests = store.GetFloorDests();
+  const uint64_t *bitsDone = store.GetFloorReqDoneBits();
+  const uint64_t *bitsServiced = store.GetServicedBits();
+  int numRequests = store.GetSize();
+
+  const __m256i vCurr = _mm256_set1_epi32(currFloor);
+  const __m256i vNow = _mm256_set1_epi32(currTime);
+  const __m256i vBitSel = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  const __m256i vOnes = _mm256_set1_epi32(-1);
+  const __m256i vOne = _mm256_set1_epi32(1);
+  const __m256i vStep = _mm256_set1_epi32(8);
+  __m256i vId = _mm256_add_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(begin));
+  __m256i vBestDist = _mm256_set1_epi32(INT_MAX), vBestId = vOnes;
+  __m256i vBestDD = _mm256_set1_epi32(INT_MAX), vNumDD = _mm256_setzero_si256(), vFirstDD = vOnes;
+  __m256i vNumActive = _mm256_setzero_si256();
+  __m256i vAbove = _mm256_setzero_si256(), vBelow = _mm256_setzero_si256(), vAt = _mm256_setzero_si256(), vDestBelow = _mm256_setzero_si256();
+
+  int id = begin;
+  for (; id + 8 <= numRequests; id += 8) {
+    // 8 flag bits -> 8 lane masks
+    __m256i vDone = _mm256_set1_epi32((int)((bitsDone[id >> 6] >> (id & 63)) & 0xFF));
+    __m256i vServiced = _mm256_set1_epi32((int)((bitsServiced[id >> 6] >> (id & 63)) & 0xFF));
+    vDone = _mm256_cmpeq_epi32(_mm256_and_si256(vDone, vBitSel), vBitSel);
+    vServiced = _mm256_cmpeq_epi32(_mm256_and_si256(vServiced, vBitSel), vBitSel);
+
+    __m256i vTime = _mm256_loadu_si256((const __m256i *)(times + id));
+    __m256i vSrc = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(srcs + id)));
+    __m256i vDest = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(dests + id)));
+
+    // in play: made by now and not serviced
+    __m256i vActive = _mm256_andnot_si256(_mm256_or_si256(vServiced, _mm256_cmpgt_epi32(vTime, vNow)), vOnes);
+    vNumActive = _mm256_sub_epi32(vNumActive, vActive);
+
+    __m256i vReq = _mm256_blendv_epi8(vSrc, vDest, vDone);
+    vAbove = _mm256_or_si256(vAbove, _mm256_and_si256(vActive, _mm256_cmpgt_epi32(vReq, vCurr)));
+    vBelow = _mm256_or_si256(vBelow, _mm256_and_si256(vActive, _mm256_cmpgt_epi32(vCurr, vReq)));
+    vAt = _mm256_or_si256(vAt, _mm256_and_si256(vActive, _mm256_cmpeq_epi32(vReq, vCurr)));
+
+    // strictly nearer only: within a lane ids grow, so the first request keeps a tie
+    __m256i vDist = _mm256_abs_epi32(_mm256_sub_epi32(vReq, vCurr));
+    __m256i vNearer = _mm256_and_si256(vActive, _mm256_cmpgt_epi32(vBestDist, vDist));
+    vBestDist = _mm256_blendv_epi8(vBestDist, vDist, vNearer);
+    vBestId = _mm256_blendv_epi8(vBestId, vId, vNearer);
+
+    __m256i vDD = _mm256_abs_epi32(_mm256_sub_epi32(vDest, vCurr));
+    vDestBelow = _mm256_or_si256(vDestBelow, _mm256_and_si256(vActive, _mm256_cmpgt_epi32(vCurr, vDest)));
+    __m256i vNearerDD = _mm256_and_si256(vActive, _mm256_cmpgt_epi32(vBestDD, vDD));
+    __m256i vSameDD = _mm256_and_si256(vActive, _mm256_cmpeq_epi32(vBestDD, vDD));
+    vNumDD = _mm256_blendv_epi8(_mm256_sub_epi32(vNumDD, vSameDD), vOne, vNearerDD);
+    vBestDD = _mm256_blendv_epi8(vBestDD, vDD, vNearerDD);
+    vFirstDD = _mm256_blendv_epi8(vFirstDD, vId, vNearerDD);
+
+    vId = _mm256_add_epi32(vId, vStep);
+  }
+
+  alignas(32) int bestDist[8], bestId[8], bestDD[8], numDD[8], firstDD[8], numActive[8];
+  _mm256_store_si256((__m256i *)bestDist, vBestDist);
+  _mm256_store_si256((__m256i *)bestId, vBestId);
+  _mm256_store_si256((__m256i *)bestDD, vBestDD);
+  _mm256_store_si256((__m256i *)numDD, vNumDD);
+  _mm256_store_si256((__m256i *)firstDD, vFirstDD);
+  _mm256_store_si256((__m256i *)numActive, vNumActive);
+  for (int l = 0; l < 8; ++l) {
+    lanes[l].bestDist = bestDist[l];
+    lanes[l].bestId = bestId[l];
+    lanes[l].bestDestDist = bestDD[l];
+    lanes[l].numBestDest = numDD[l];
+    lanes[l].firstBestDest = firstDD[l];
+    flags.numActive += numActive[l];
+  }
+  flags.fAbove |= _mm256_movemask_epi8(vAbove) != 0;
+  flags.fBelow |= _mm256_movemask_epi8(vBelow) != 0;
+  flags.fAt |= _mm256_movemask_epi8(vAt) != 0;
+  flags.fDestBelow |= _mm256_movemask_epi8(vDestBelow) != 0;
+  return id;
+}
+
+// *********************** SSE4.1: 4 requests ******************
+// *************************************************************
+__attribute__((target("sse4.1")))
+static int ScanSse41(const ECElevatorRequestStore &store, int begin, int currFloor, int currTime, ECScanLane lanes[4], ECScanFlags &flags) {
+  const int32_t *times = store.GetTimes();
+  const int16_t *srcs = store.GetFloorSrcs();
+  const int16_t *dests = store.GetFloorDests();
+  const uint64_t *bitsDone = store.GetFloorReqDoneBits();
+  const uint64_t *bitsServiced = store.GetServicedBits();
+  int numRequests = store.GetSize();
+
+  const __m128i vCurr = _mm_set1_epi32(currFloor);
+  const __m128i vNow = _mm_set1_epi32(currTime);
+  const __m128i vBitSel = _mm_setr_epi32(1, 2, 4, 8);
+  const __m128i vOnes = _mm_set1_epi32(-1);
+  const __m128i vOne = _mm_set1_epi32(1);
+  const __m128i vStep = _mm_set1_epi32(4);
+  __m128i vId = _mm_add_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(begin));
+  __m128i vBestDist = _mm_set1_epi32(INT_MAX), vBestId = vOnes;
+  __m128i vBestDD = _mm_set1_epi32(INT_MAX), vNumDD = _mm_setzero_si128(), vFirstDD = vOnes;
+  __m128i vNumActive = _mm_setzero_si128();
+  __m128i vAbove = _mm_setzero_si128(), vBelow = _mm_setzero_si128(), vAt = _mm_setzero_si128(), vDestBelow = _mm_setzero_si128();
+
+  int id = begin;
+  for (; id + 4 <= numRequests; id += 4) {
+    __m128i vDone = _mm_set1_epi32((int)((bitsDone[id >> 6] >> (id & 63)) & 0xF));
+    __m128i vServiced = _mm_set1_epi32((int)((bitsServiced[id >> 6] >> (id & 63)) & 0xF));
+    vDone = _mm_cmpeq_epi32(_mm_and_si128(vDone, vBitSel), vBitSel);
+    vServiced = _mm_cmpeq_epi32(_mm_and_si128(vServiced, vBitSel), vBitSel);
+
+    __m128i vTime = _mm_loadu_si128((const __m128i *)(times + id));
+    __m128i vSrc = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(srcs + id)));
+    __m128i vDest = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(dests + id)));
+
+    __m128i vActive = _mm_andnot_si128(_mm_or_si128(vServiced, _mm_cmpgt_epi32(vTime, vNow)), vOnes);
+    vNumActive = _mm_sub_epi32(vNumActive, vActive);
+
+    __m128i vReq = _mm_blendv_epi8(vSrc, vDest, vDone);
+    vAbove = _mm_or_si128(vAbove, _mm_and_si128(vActive, _mm_cmpgt_epi32(vReq, vCurr)));
+    vBelow = _mm_or_si128(vBelow, _mm_and_si128(vActive, _mm_cmpgt_epi32(vCurr, vReq)));
+    vAt = _mm_or_si128(vAt, _mm_and_si128(vActive, _mm_cmpeq_epi32(vReq, vCurr)));
+
+    __m128i vDist = _mm_abs_epi32(_mm_sub_epi32(vReq, vCurr));
+    __m128i vNearer = _mm_and_si128(vActive, _mm_cmpgt_epi32(vBestDist, vDist));
+    vBestDist = _mm_blendv_epi8(vBestDist, vDist, vNearer);
+    vBestId = _mm_blendv_epi8(vBestId, vId, vNearer);
+
+    __m128i vDD = _mm_abs_epi32(_mm_sub_epi32(vDest, vCurr));
+    vDestBelow = _mm_or_si128(vDestBelow, _mm_and_si128(vActive, _mm_cmpgt_epi32(vCurr, vDest)));
+    __m128i vNearerDD = _mm_and_si128(vActive, _mm_cmpgt_epi32(vBestDD, vDD));
+    __m128i vSameDD = _mm_and_si128(vActive, _mm_cmpeq_epi32(vBestDD, vDD));
+    vNumDD = _mm_blendv_epi8(_mm_sub_epi32(vNumDD, vSameDD), vOne, vNearerDD);
+    vBestDD = _mm_blendv_epi8(vBestDD, vDD, vNearerDD);
+    vFirstDD = _mm_blendv_epi8(vFirstDD, vId, vNearerDD);
+
+    vId = _mm_add_epi32(vId, vStep);
+  }
+
+  alignas(16) int bestDist[4], bestId[4], bestDD[4], numDD[4], firstDD[4], numActive[4];
+  _mm_store_si128((__m128i *)bestDist, vBestDist);
+  _mm_store_si128((__m128i *)bestId, vBestId);
+  _mm_store_si128((__m128i *)bestDD, vBestDD);
+  _mm_store_si128((__m128i *)numDD, vNumDD);
+  _mm_store_si128((__m128i *)firstDD, vFirstDD);
+  _mm_store_si128((__m128i *)numActive, vNumActive);
+  for (int l = 0; l < 4; ++l) {
+    lanes[l].bestDist = bestDist[l];
+    lanes[l].bestId = bestId[l];
+    lanes[l].bestDestDist = bestDD[l];
+    lanes[l].numBestDest = numDD[l];
+    lanes[l].firstBestDest = firstDD[l];
+    flags.numActive += numActive[l];
+  }
+  flags.fAbove |= _mm_movemask_epi8(vAbove) != 0;
+  flags.fBelow |= _mm_movemask_epi8(vBelow) != 0;
+  flags.fAt |= _mm_movemask_epi8(vAt) != 0;
+  flags.fDestBelow |= _mm_movemask_epi8(vDestBelow) != 0;
+  return id;
+}
+
+#endif /* EC_ELEVATOR_SIMD_X86 */
+
+// ************************** dispatch *************************
+// *************************************************************
+EC_ELEVATOR_SIMD_LEVEL ECElevatorGetBestSimdLevel() {
+#ifdef EC_ELEVATOR_SIMD_X86
+  if (__builtin_cpu_supports("avx2")) {
+    return EC_ELEVATOR_SIMD_AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return EC_ELEVATOR_SIMD_SSE41;
+  }
+#endif
+  return EC_ELEVATOR_SIMD_SCALAR;
+}
+
+static EC_ELEVATOR_SIMD_LEVEL simdLevel = ECElevatorGetBestSimdLevel();
+
+EC_ELEVATOR_SIMD_LEVEL ECElevatorGetSimdLevel() {
+  return simdLevel;
+}
+void ECElevatorSetSimdLevel(EC_ELEVATOR_SIMD_LEVEL level) {
+  simdLevel = std::min(level, ECElevatorGetBestSimdLevel());
+}
+
+void ECElevatorScanRequests(const ECElevatorRequestStore &store, int currFloor, int currTime, ECElevatorScanResult &result) {
+  ECScanLane lanes[9];
+  ECScanFlags flags;
+  int numLanes = 0;
+  // retired (serviced) requests are skipped; start on a word of flags so the
+  // kernels' 4/8 flag bits never straddle two words
+  int begin = store.GetFirstLive() & ~63;
+  int done = begin;
+#ifdef EC_ELEVATOR_SIMD_X86
+  if (simdLevel == EC_ELEVATOR_SIMD_AVX2) {
+    done = ScanAvx2(store, begin, currFloor, currTime, lanes, flags);
+    numLanes = 8;
+  }
+  else if (simdLevel == EC_ELEVATOR_SIMD_SSE41) {
+    done = ScanSse41(store, begin, currFloor, currTime, lanes, flags);
+    numLanes = 4;
+  }
+#endif
+  // the rest (or everything) one by one, in a lane of its own
+  ScanScalar(store, currFloor, currTime, done, store.GetSize(), lanes[numLanes], flags);
+  ++numLanes;
+
+  // combine lanes: nearest distance first, then first id
+  result = ECElevatorScanResult();
+  result.numActive = flags.numActive;
+  result.fReqAbove = flags.fAbove;
+  result.fReqBelow = flags.fBelow;
+  result.fReqAt = flags.fAt;
+  result.fDestBelow = flags.fDestBelow;
+  int bestDist = INT_MAX, bestDD = INT_MAX;
+  for (int l = 0; l < numLanes; ++l) {
+    const ECScanLane &lane = lanes[l];
+    if (lane.bestId >= 0 && (lane.bestDist < bestDist || (lane.bestDist == bestDist && lane.bestId < result.nearestId))) {
+      bestDist = lane.bestDist;
+      result.nearestId = lane.bestId;
+    }
+    if (lane.firstBestDest < 0) {
+      continue;
+    }
+    if (lane.bestDestDist < bestDD) {
+      bestDD = lane.bestDestDist;
+      result.numNearestDest = lane.numBestDest;
+      result.firstNearestDestId = lane.firstBestDest;
+    }
+    else if (lane.bestDestDist == bestDD) {
+      result.numNearestDest += lane.numBestDest;
+      result.firstNearestDestId = std::min(result.firstNearestDestId, lane.firstBestDest);
+    }
+  }
+  if (result.nearestId >= 0) {
+    result.nearestFloor = store.IsFloorRequestDone(result.nearestId) ? store.GetFloorDest(result.nearestId) : store.GetFloorSrc(result.nearestId);
+  }
+  if (result.firstNearestDestId >= 0) {
+    result.nearestDestDistance = bestDD;
+  }
+}
+
+// ************************* decisions *************************
+// *************************************************************
+EC_ELEVATOR_DIR ECElevatorScanNearestDir(const ECElevatorScanResult &result, int currFloor) {
+  if (result.nearestFloor < 0) {
+    return EC_ELEVATOR_STOPPED;
+  }
+  return (result.nearestFloor > currFloor) ? EC_ELEVATOR_UP : EC_ELEVATOR_DOWN;
+}
+
+bool ECElevatorScanHasReqAhead(const ECElevatorScanResult &result, EC_ELEVATOR_DIR currDir) {
+  return (currDir == EC_ELEVATOR_UP && result.fReqAbove) || (currDir == EC_ELEVATOR_DOWN && result.fReqBelow) || result.fReqAt;
+}
+
+EC_ELEVATOR_DIR ECElevatorScanStopOverDir(const ECElevatorScanResult &result, const ECElevatorRequestStore &store, int currFloor, EC_ELEVATOR_DIR currDir) {
+  if (result.numActive == 0) {
+    return EC_ELEVATOR_STOPPED;
+  }
+  if (currDir == EC_ELEVATOR_DOWN && result.fDestBelow) {
+    return EC_ELEVATOR_DOWN;
+  }
+  if (currDir == EC_ELEVATOR_UP) {
+    return EC_ELEVATOR_UP;
+  }
+  if (result.numNearestDest > 1 && currDir != EC_ELEVATOR_DOWN) {
+    return EC_ELEVATOR_UP; // if distance is the same, always go UP
+  }
+  // the first of the nearest requests decides
+  int id = result.firstNearestDestId;
+  int requested = store.IsFloorRequestDone(id) ? store.GetFloorDest(id) : store.GetFloorSrc(id);
+  return (requested > currFloor) ? EC_ELEVATOR_UP : EC_ELEVATOR_DOWN;
+}
@@ -0,0 +1,58 @@
+#ifndef ECElevatorSimd_h
+#define ECElevatorSimd_h
+
+#include "ECElevatorRequestStore.h"
+
+//*****************************************************************************
+// Vectorized scan of a request store for the elevator's direction decisions
+//
+// One pass over the columns (times, floors, stage flags), from the first request
+// not serviced yet, answers everything the states ask about the requests in play
+// (made by currTime, not serviced): is there a request above/below/at the current
+// floor, which requested floor is nearest (ties: first request in the list), and
+// the destination-based numbers ECElevatorStopOver turns on.
+// The kernel is picked at run time: AVX2 (8 requests at a time), SSE4.1 (4) or
+// plain C++ on other CPUs; all of them give the same result.
+
+enum EC_ELEVATOR_SIMD_LEVEL
+{
+    EC_ELEVATOR_SIMD_SCALAR = 0,
+    EC_ELEVATOR_SIMD_SSE41,
+    EC_ELEVATOR_SIMD_AVX2
+};
+
+struct ECElevatorScanResult
+{
+    int numActive = 0;
+    // requested floor: floorSrc while waiting, floorDest once inside
+    bool fReqAbove = false;
+    bool fReqBelow = false;
+    bool fReqAt = false;
+    int nearestFloor = -1;      // nearest requested floor (-1: none)
+    int nearestId = -1;         // first request at the nearest distance
+    // floorDest of every request in play
+    bool fDestBelow = false;
+    int nearestDestDistance = -1;
+    int numNearestDest = 0;
+    int firstNearestDestId = -1;
+};
+
+// Best level this CPU supports, and the level in use (defaults to the best one)
+EC_ELEVATOR_SIMD_LEVEL ECElevatorGetBestSimdLevel();
+EC_ELEVATOR_SIMD_LEVEL ECElevatorGetSimdLevel();
+// Force a level (e.g., to compare kernels); capped at the best supported one
+void ECElevatorSetSimdLevel(EC_ELEVATOR_SIMD_LEVEL level);
+
+// Scan all requests of the store
+void ECElevatorScanRequests(const ECElevatorRequestStore &store, int currFloor, int currTime, ECElevatorScanResult &result);
+
+// Decisions of the default dispatch policy from a scan
+// ECElevatorNearestDir (ECElevatorDispatch.h): head to the nearest request (STOPPED: none)
+EC_ELEVATOR_DIR ECElevatorScanNearestDir(const ECElevatorScanResult &result, int currFloor);
+// ECElevatorHasReqAhead: any request at this floor or ahead
+bool ECElevatorScanHasReqAhead(const ECElevatorScanResult &result, EC_ELEVATOR_DIR currDir);
+// ECElevatorDefaultPolicy::Leave: keep going down if there is a destination below;
+// ties go up unless already going down (STOPPED: nothing in play)
+EC_ELEVATOR_DIR ECElevatorScanStopOverDir(const ECElevatorScanResult &result, const ECElevatorRequestStore &store, int currFloor, EC_ELEVATOR_DIR currDir);
+
+#endif /* ECElevatorSimd_h */
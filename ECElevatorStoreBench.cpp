@@ -0,0 +1,86 @@
+#include "ECElevatorRequestStore.h"
+#include "ECElevatorSimd.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+// Scan bandwidth: list of ECElevatorSimRequest (array of structs) vs ECElevatorRequestStore (columns)
+// Each scan counts the requests made by some time and not serviced yet, as the states used to do every tick.
+// The scan_* cases run the full direction scan (ECElevatorScanRequests) with each kernel this CPU supports.
+// The serviced requests are the oldest ones: the store and scan_* cases start past them (retired), the list can't.
+//     ECElevatorStoreBench [numRequests] [numScans]
+// One line per case: layout,requests,serviced_pct,scans,ns_per_request,mreq_per_sec,bytes_per_request
+
+static int ScanList(const std::vector<ECElevatorSimRequest> &listRequests, int currentTime)
+{
+    int numPending = 0;
+    for(auto &request : listRequests)
+    {
+        numPending += !request.IsServiced() && request.GetTime() <= currentTime;
+    }
+    return numPending;
+}
+
+template<class TScan>
+static void Run(const char *layout, int numRequests, int pctServiced, int numScans, double bytesPerRequest, TScan scan)
+{
+    volatile long total = 0;
+    auto tmStart = std::chrono::steady_clock::now();
+    for(int i=0; i<numScans; ++i)
+    {
+        total = total + scan(i);
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - tmStart).count();
+    double numScanned = (double)numRequests * numScans;
+    printf("%s,%d,%d,%d,%.3f,%.1f,%.2f\n", layout, numRequests, pctServiced, numScans, 1e9 * secs / numScanned, numScanned / secs / 1e6, bytesPerRequest);
+}
+
+int main(int argc, char **argv)
+{
+    int numRequests = argc > 1 ? atoi(argv[1]) : 2000000;
+    int numScans = argc > 2 ? atoi(argv[2]) : 50;
+
+    printf("layout,requests,serviced_pct,scans,ns_per_request,mreq_per_sec,bytes_per_request\n");
+    for(int pctServiced : {0, 90, 99})
+    {
+        std::mt19937 rng(7);
+        std::vector<ECElevatorSimRequest> listRequests;
+        listRequests.reserve(numRequests);
+        for(int i=0; i<numRequests; ++i)
+        {
+            // requests in time order; the oldest ones are serviced
+            ECElevatorSimRequest request(i / 4, 1 + rng() % 50, 1 + rng() % 50);
+            if( (long)i * 100 < (long)numRequests * pctServiced )
+            {
+                request.SetFloorRequestDone(true);
+                request.SetServiced(true);
+                request.SetArriveTime(i / 4 + 10);
+            }
+            listRequests.push_back(request);
+        }
+        ECElevatorRequestStore store(listRequests);
+        int timeNow = numRequests / 4;
+
+        Run("list", numRequests, pctServiced, numScans, sizeof(ECElevatorSimRequest), [&](int i) {
+            return ScanList(listRequests, timeNow - i);
+        });
+        // time column (4 bytes) + serviced bit
+        Run("store", numRequests, pctServiced, numScans, 4.0 + 1.0 / 8, [&](int i) {
+            return store.CountPending(timeNow - i);
+        });
+        // times, both floors, both flag bits
+        const char *kernels[] = {"scan_scalar", "scan_sse41", "scan_avx2"};
+        for(int level = EC_ELEVATOR_SIMD_SCALAR; level <= ECElevatorGetBestSimdLevel(); ++level)
+        {
+            ECElevatorSetSimdLevel((EC_ELEVATOR_SIMD_LEVEL)level);
+            Run(kernels[level], numRequests, pctServiced, numScans, 8.0 + 2.0 / 8, [&](int i) {
+                ECElevatorScanResult result;
+                ECElevatorScanRequests(store, 1 + i % 50, timeNow - i, result);
+                return result.numActive + result.nearestId;
+            });
+        }
+        ECElevatorSetSimdLevel(ECElevatorGetBestSimdLevel());
+    }
+    return 0;
+}
@@ -2,7 +2,24 @@
 
 #include <vector>
 #include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <string>
 #include "ECElevatorSim.h"
+#include "ECElevatorBank.h"
+#include "ECElevatorArena.h"
+#include "ECElevatorSimRunner.h"
+#include "ECElevatorBatch.h"
+#include "ECElevatorRequestFile.h"
+#include "ECElevatorRequestStore.h"
+#include "ECElevatorSimd.h"
+#include "ECElevatorCallIndex.h"
+#include "ECElevatorDispatch.h"
+#include "ECElevatorAllocCounter.h"   // counts heap allocations (see Test10)
+#include <sstream>
+#include <atomic>
+#include <thread>
 
 using namespace std;
 
@@ -324,6 +341,1033 @@ static void Test8()
     RunTest1(NUM_FLOORS, timeSim, listRequests, listArriveTime);
 }
 
+// Sparse requests: the parked elevator skips the idle ticks between them
+// Passenger 1: same as in Test0 (arrives at time 7)
+// Passenger 2: same trip made at time 1000 (arrives at time 1005)
+// the clock jumps from time 0 to 2, from 9 to 1000, and from 1007 to the end (1010)
+static void Test9()
+{
+    cout << "\n****** TEST 9\n";
+    // test setup
+    const int NUM_FLOORS = 7;
+    const int timeSim = 1010;
+    ECElevatorSimRequest r1(2, 3, 1), r2(1000, 3, 1);
+    vector<ECElevatorSimRequest> listRequests;
+    listRequests.push_back(r1);
+    listRequests.push_back(r2);
+
+    // simulate
+    ECElevatorSim sim(NUM_FLOORS, listRequests);
+    sim.Simulate(timeSim);
+    ASSERT_EQ(listRequests[0].GetArriveTime(), 7);
+    ASSERT_EQ(listRequests[1].GetArriveTime(), 1005);
+    ASSERT_EQ(sim.GetNumSkippedTicks(), 2 + (1000 - 9) + (1010 - 1007));
+    ASSERT_EQ(sim.GetCurrentTime(), timeSim);
+}
+
+// A busy run (the requests of Test8) switches states many times:
+// once the simulation is set up, the tick loop doesn't allocate at all
+static void Test10()
+{
+    cout << "\n****** TEST 10\n";
+    // test setup
+    const int NUM_FLOORS = 3;
+    const int timeSim = 50;
+    ECElevatorSimRequest r1(1, 3, 1), r2(2, 3, 2), r3(10, 2, 3), r4(14, 2, 1), r5(20, 3, 2), r6(30, 3, 1), r7(34, 3, 2), r8(26, 2, 3), r9(28, 2, 1), r10(16, 3, 2);
+    vector<ECElevatorSimRequest> listRequests;
+    listRequests.push_back(r1);
+    listRequests.push_back(r2);
+    listRequests.push_back(r3);
+    listRequests.push_back(r4);
+    listRequests.push_back(r5);
+    listRequests.push_back(r6);
+    listRequests.push_back(r7);
+    listRequests.push_back(r8);
+    listRequests.push_back(r9);
+    listRequests.push_back(r10);
+
+    // simulate
+    ECElevatorSim sim(NUM_FLOORS, listRequests);
+    long numAllocationsBefore = ECElevatorGetNumAllocations();
+    sim.Simulate(timeSim);
+    ASSERT_EQ(ECElevatorGetNumAllocations() - numAllocationsBefore, 0L);
+    ASSERT_EQ(listRequests[9].GetArriveTime(), 22);
+}
+
+// Tracing: passenger events of Test1 go to a trace file; the other levels are off at run time
+static void Test11()
+{
+    cout << "\n****** TEST 11\n";
+#if EC_TRACE_LEVEL > 0
+    const int NUM_FLOORS = 7;
+    const int timeSim = 20;
+    ECElevatorSimRequest r1(2, 3, 5), r2(2, 6, 1);
+    vector<ECElevatorSimRequest> listRequests;
+    listRequests.push_back(r1);
+    listRequests.push_back(r2);
+
+    const char *fileTrace = "ECElevatorTest.trace";
+    {
+        ECElevatorTraceSink sink(fileTrace, EC_TRACE_PASSENGER);
+        ECElevatorSim sim(NUM_FLOORS, listRequests);
+        sim.SetTraceSink(&sink);
+        sim.Simulate(timeSim);
+        sink.Flush();
+        ASSERT_EQ(sink.GetNumRecorded(), 4L);   // two boarded, two arrived
+        ASSERT_EQ(sink.GetNumDropped(), 0L);
+    }
+    ifstream in(fileTrace);
+    string line;
+    int numArrived = 0;
+    while( getline(in, line) )
+    {
+        if( line.find("arrived") != string::npos )
+        {
+            ++numArrived;
+        }
+    }
+    ASSERT_EQ(numArrived, 2);
+    remove(fileTrace);
+#endif
+}
+
+// Bank of elevators: with one car, the bank behaves exactly like ECElevatorSim (Test4);
+// with two cars, every passenger still arrives, and no later on average
+static void Test12()
+{
+    cout << "\n****** TEST 12\n";
+    // test setup
+    const int NUM_FLOORS = 8;
+    const int timeSim = 35;
+    ECElevatorSimRequest r1(2, 3, 1), r2(3, 5, 1), r3(8, 2, 3), r4(10, 6, 1);
+    vector<ECElevatorSimRequest> listRequests;
+    listRequests.push_back(r1);
+    listRequests.push_back(r2);
+    listRequests.push_back(r3);
+    listRequests.push_back(r4);
+    vector<ECElevatorSimRequest> listRequests2 = listRequests;
+    vector<ECElevatorSimRequest> listRequests0 = listRequests;
+
+    ECElevatorBank bank1(NUM_FLOORS, 1, listRequests);
+    bank1.Simulate(timeSim);
+    ASSERT_EQ(listRequests[0].GetArriveTime(), 13);
+    ASSERT_EQ(listRequests[1].GetArriveTime(), 13);
+    ASSERT_EQ(listRequests[2].GetArriveTime(), 16);
+    ASSERT_EQ(listRequests[3].GetArriveTime(), 26);
+
+    ECElevatorBank bank2(NUM_FLOORS, 2, listRequests2);
+    bank2.Simulate(timeSim);
+    ECElevatorHistogram histWait2, histJourney2;
+    for(int i=0; i<bank2.GetNumCars(); ++i)
+    {
+        histWait2.Add(bank2.GetCar(i).GetWaitHistogram());
+        histJourney2.Add(bank2.GetCar(i).GetJourneyHistogram());
+    }
+    ASSERT_EQ(histJourney2.GetCount(), 4L);
+    ASSERT_EQ(histWait2.GetMean() <= bank1.GetCar(0).GetWaitHistogram().GetMean(), true);
+
+    // a bank of no cars gets one
+    ECElevatorBank bank0(NUM_FLOORS, 0, listRequests0);
+    ASSERT_EQ(bank0.GetNumCars(), 1);
+    bank0.Simulate(timeSim);
+    ASSERT_EQ(listRequests0[3].GetArriveTime(), 26);
+}
+
+// Batch of scenarios (the requests of Test1-Test4, with 1 and 2 cars): the result table
+// is the same with one thread or four, and matches running each scenario alone
+static void Test13()
+{
+    cout << "\n****** TEST 13\n";
+    vector<ECElevatorSimRequest> listRequests;
+    listRequests.push_back(ECElevatorSimRequest(2, 3, 5));
+    listRequests.push_back(ECElevatorSimRequest(2, 6, 1));
+    listRequests.push_back(ECElevatorSimRequest(2, 4, 1));
+    listRequests.push_back(ECElevatorSimRequest(3, 5, 2));
+    listRequests.push_back(ECElevatorSimRequest(12, 5, 1));
+    listRequests.push_back(ECElevatorSimRequest(8, 2, 3));
+    listRequests.push_back(ECElevatorSimRequest(10, 6, 1));
+    const char *fileRequests = "ECElevatorTest.requests";
+    ECElevatorWriteRequestFile(fileRequests, listRequests);
+
+    ECElevatorBatch batch;
+    for(int i=0; i<8; ++i)
+    {
+        ECElevatorScenario scenario;
+        scenario.name = "scenario" + to_string(i);
+        scenario.numFloors = 8;
+        scenario.lenSim = 20 + 10 * i;
+        scenario.fileRequests = fileRequests;
+        scenario.numCars = 1 + i % 2;
+        batch.AddScenario(scenario);
+    }
+    ostringstream out1, out4;
+    batch.Run(1);
+    batch.WriteResults(out1, false);
+    batch.Run(4);
+    batch.WriteResults(out4, false);
+    ASSERT_EQ(out1.str() == out4.str(), true);
+
+    vector<ECElevatorSimRequest> listRequests2 = listRequests;
+    ECElevatorSim sim(8, listRequests2);
+    sim.Simulate(80);
+    // scenario6: one car, time 80
+    const ECElevatorScenarioResult &result = batch.GetResults()[6];
+    ASSERT_EQ((long)result.numServiced, sim.GetJourneyHistogram().GetCount());
+    ASSERT_EQ(result.meanWait, sim.GetWaitHistogram().GetMean());
+    ASSERT_EQ(result.p95Wait, sim.GetWaitHistogram().GetPercentile(95));
+
+    // scenario files: the policy is read by name; an unknown one is an error
+    const char *fileScenarios = "ECElevatorTest.scenarios";
+    ofstream(fileScenarios) << "# name floors time requests cars dispatch\nlook 8 40 " << fileRequests << " 2 look\n";
+    ECElevatorBatch batchRead;
+    ASSERT_EQ(batchRead.ReadScenarioFile(fileScenarios), true);
+    ASSERT_EQ(batchRead.GetNumScenarios(), 1);
+    ofstream(fileScenarios) << "up 8 40 " << fileRequests << " 2 elevator\n";
+    ASSERT_EQ(batchRead.ReadScenarioFile(fileScenarios), false);
+    ASSERT_EQ(batchRead.GetNumScenarios(), 1);
+    // so is a line missing the cars, or with a number that isn't one, or one field too many
+    ofstream(fileScenarios) << "up 8 40 " << fileRequests << " look\n";
+    ASSERT_EQ(batchRead.ReadScenarioFile(fileScenarios), false);
+    ofstream(fileScenarios) << "up 8 4O " << fileRequests << "\n";
+    ASSERT_EQ(batchRead.ReadScenarioFile(fileScenarios), false);
+    ofstream(fileScenarios) << "up 8 40 " << fileRequests << " 2 look 3\n";
+    ASSERT_EQ(batchRead.ReadScenarioFile(fileScenarios), false);
+    ASSERT_EQ(batchRead.GetNumScenarios(), 1);
+    remove(fileScenarios);
+    remove(fileRequests);
+}
+
+// Streaming: the requests of Test3 read from a file (text, then binary) as the simulation goes
+// passengers arrive at times 8, 13 and 23, as in Test3
+static void Test14()
+{
+    cout << "\n****** TEST 14\n";
+    const int NUM_FLOORS = 8;
+    const int timeSim = 25;
+    vector<ECElevatorSimRequest> listRequests;
+    listRequests.push_back(ECElevatorSimRequest(2, 4, 1));
+    listRequests.push_back(ECElevatorSimRequest(3, 2, 5));
+    listRequests.push_back(ECElevatorSimRequest(12, 5, 1));
+    const char *fileRequests = "ECElevatorTest.requests";
+
+    for(int fBinary=0; fBinary<=1; ++fBinary)
+    {
+        ECElevatorWriteRequestFile(fileRequests, listRequests, fBinary);
+        ECElevatorRequestReader reader;
+        ASSERT_EQ(reader.Open(fileRequests), true);
+        ASSERT_EQ(reader.IsBinary(), (bool)fBinary);
+        vector<int> listArriveTime;
+        ECElevatorSim sim(NUM_FLOORS, reader);
+        sim.SetArriveHandler([&listArriveTime](const ECElevatorSimRequest &request) {
+            listArriveTime.push_back(request.GetArriveTime());
+        });
+        sim.Simulate(timeSim);
+        ASSERT_EQ(listArriveTime.size(), (size_t)3);
+        ASSERT_EQ(listArriveTime[0], 8);
+        ASSERT_EQ(listArriveTime[1], 13);
+        ASSERT_EQ(listArriveTime[2], 23);
+    }
+    remove(fileRequests);
+}
+
+// Column store: run Test2, copy the requests into a store, serve them again through
+// the store's request handles, and write them back
+static void Test15()
+{
+    cout << "\n****** TEST 15\n";
+    const int NUM_FLOORS = 7;
+    const int timeSim = 20;
+    vector<ECElevatorSimRequest> listRequests;
+    listRequests.push_back(ECElevatorSimRequest(2, 4, 1));
+    listRequests.push_back(ECElevatorSimRequest(3, 5, 2));
+    listRequests.push_back(ECElevatorSimRequest(30, 5, 2));
+    ECElevatorSim sim(NUM_FLOORS, listRequests);
+    sim.Simulate(timeSim);
+
+    ECElevatorRequestStore store(listRequests);
+    ASSERT_EQ(store.GetSize(), 3);
+    ASSERT_EQ(store[0].GetArriveTime(), 13);
+    ASSERT_EQ(store[1].GetArriveTime(), 11);
+    ASSERT_EQ(store[1].IsServiced(), true);
+    ASSERT_EQ(store.CountPending(timeSim), 0);
+    ASSERT_EQ(store.CountPending(30), 1);
+
+    // request 2 is served through its handle
+    ECElevatorRequestRef request = store[2];
+    ASSERT_EQ(request.GetRequestedFloor(), 5);
+    request.SetFloorRequestDone(true);
+    ASSERT_EQ(request.GetRequestedFloor(), 2);
+    request.SetServiced(true);
+    request.SetArriveTime(36);
+    ASSERT_EQ(store.CountPending(30), 0);
+
+    store.WriteBack(listRequests);
+    ASSERT_EQ(listRequests[2].IsServiced(), true);
+    ASSERT_EQ(listRequests[2].GetArriveTime(), 36);
+    ASSERT_EQ(listRequests[0].GetArriveTime(), 13);
+}
+
+// Vectorized scan: after every tick of a random run, every kernel this CPU has
+// must agree with the call index the states use
+static void Test16()
+{
+    cout << "\n****** TEST 16\n";
+    const int NUM_FLOORS = 20;
+    const int timeSim = 400;
+    srand(16);
+    vector<ECElevatorSimRequest> listRequests;
+    for(int i=0; i<101; ++i)
+    {
+        int floorSrc = 1 + rand() % NUM_FLOORS;
+        int floorDest = 1 + rand() % NUM_FLOORS;
+        if( floorDest == floorSrc )
+        {
+            floorDest = floorSrc % NUM_FLOORS + 1;
+        }
+        listRequests.push_back(ECElevatorSimRequest(i * 2, floorSrc, floorDest));
+    }
+    ECElevatorSim sim(NUM_FLOORS, listRequests);
+    const ECElevatorCallIndex &calls = sim.GetCallIndex();
+    int numMismatches = 0;
+    for(int t=0; t<timeSim; ++t)
+    {
+        sim.AdvanceOneTick();
+        ECElevatorRequestStore store(listRequests);
+        int currFloor = sim.GetCurrFloor();
+        for(int level = EC_ELEVATOR_SIMD_SCALAR; level <= ECElevatorGetBestSimdLevel(); ++level)
+        {
+            ECElevatorSetSimdLevel((EC_ELEVATOR_SIMD_LEVEL)level);
+            ECElevatorScanResult result;
+            ECElevatorScanRequests(store, currFloor, sim.GetCurrentTime() - 1, result);
+            int distance = calls.NearestDestDistance(currFloor);
+            int numNearest = calls.GetNumDestAt(currFloor + distance) + (distance > 0 ? calls.GetNumDestAt(currFloor - distance) : 0);
+            int above = calls.FirstDestAt(currFloor + distance);
+            int below = calls.FirstDestAt(currFloor - distance);
+            int first = (below >= 0 && (above < 0 || below < above)) ? below : above;
+            bool fSame = result.numActive == calls.GetNumActive() &&
+                result.fReqAbove == calls.HasRequestAbove(currFloor) &&
+                result.fReqBelow == calls.HasRequestBelow(currFloor) &&
+                result.fReqAt == calls.HasRequestAt(currFloor) &&
+                result.nearestFloor == calls.NearestRequestFloor(currFloor) &&
+                result.fDestBelow == calls.HasDestBelow(currFloor) &&
+                result.nearestDestDistance == distance &&
+                (calls.IsEmpty() || (result.numNearestDest == numNearest && result.firstNearestDestId == first));
+            if( !fSame )
+            {
+                cout << "Mismatch at time " << sim.GetCurrentTime() - 1 << ", level " << level << endl;
+                ++numMismatches;
+            }
+        }
+    }
+    ECElevatorSetSimdLevel(ECElevatorGetBestSimdLevel());
+    ASSERT_EQ(numMismatches, 0);
+    ASSERT_EQ(listRequests[100].IsServiced(), true);
+}
+
+// Wait/ride histograms: Test2 queried during and after the run (passenger 1 boards
+// at time 5, passenger 2 at time 7), then a large spread of values
+static void Test17()
+{
+    cout << "\n****** TEST 17\n";
+    const int NUM_FLOORS = 7;
+    vector<ECElevatorSimRequest> listRequests;
+    listRequests.push_back(ECElevatorSimRequest(2, 4, 1));
+    listRequests.push_back(ECElevatorSimRequest(3, 5, 2));
+    ECElevatorSim sim(NUM_FLOORS, listRequests);
+    sim.Simulate(6);
+    ASSERT_EQ(sim.GetBoardTime(0), 5);
+    ASSERT_EQ(sim.GetBoardTime(1), -1);
+    ASSERT_EQ(sim.GetWaitHistogram().GetCount(), 1L);
+    ASSERT_EQ(sim.GetRideHistogram().GetCount(), 0L);
+    sim.Simulate(20);
+    ASSERT_EQ(sim.GetBoardTime(1), 7);
+    const ECElevatorHistogram &histWait = sim.GetWaitHistogram();
+    ASSERT_EQ(histWait.GetMin(), 3);
+    ASSERT_EQ(histWait.GetMax(), 4);
+    ASSERT_EQ(histWait.GetMean(), 3.5);
+    ASSERT_EQ(sim.GetRideHistogram().GetPercentile(50), 4);
+    ASSERT_EQ(sim.GetRideHistogram().GetPercentile(100), 8);
+    ASSERT_EQ(sim.GetJourneyHistogram().GetPercentile(99), 11);
+    ASSERT_EQ(sim.GetJourneyHistogram().GetMean(), 9.5);
+
+    // above 32 ticks, percentiles are within 1/32 of the value
+    ECElevatorHistogram hist;
+    for(int t=1; t<=100000; ++t)
+    {
+        hist.Record(t);
+    }
+    ASSERT_EQ(hist.GetCount(), 100000L);
+    ASSERT_EQ(hist.GetPercentile(50) >= 50000 && hist.GetPercentile(50) <= 50000 + 50000/32, true);
+    ASSERT_EQ(hist.GetPercentile(99) >= 99000 && hist.GetPercentile(99) <= 99000 + 99000/32, true);
+    ASSERT_EQ(hist.GetPercentile(100), 100000);
+}
+
+// Checkpoints: a run restored from time 150 (into a new simulation, or back into
+// the same one) ends the same as the run straight through; a fork may add requests
+static void Test18()
+{
+    cout << "\n****** TEST 18\n";
+    const int NUM_FLOORS = 20;
+    const int timeSim = 400;
+    srand(18);
+    vector<ECElevatorSimRequest> listRequests;
+    for(int i=0; i<101; ++i)
+    {
+        int floorSrc = 1 + rand() % NUM_FLOORS;
+        int floorDest = 1 + rand() % NUM_FLOORS;
+        if( floorDest == floorSrc )
+        {
+            floorDest = floorSrc % NUM_FLOORS + 1;
+        }
+        listRequests.push_back(ECElevatorSimRequest(i * 2, floorSrc, floorDest));
+    }
+    vector<ECElevatorSimRequest> listStraight(listRequests), listBranch(listRequests), listRestored(listRequests);
+    ECElevatorSim simStraight(NUM_FLOORS, listStraight);
+    simStraight.Simulate(timeSim);
+
+    ECElevatorSim sim(NUM_FLOORS, listBranch);
+    sim.Simulate(150);
+    vector<uint8_t> blob;
+    ASSERT_EQ(sim.SaveCheckpoint(blob), true);
+    cout << "Checkpoint: " << blob.size() << " bytes\n";
+    sim.Simulate(timeSim);
+
+    ECElevatorSim simRestored(NUM_FLOORS, listRestored);
+    ASSERT_EQ(simRestored.RestoreCheckpoint(blob), true);
+    ASSERT_EQ(simRestored.GetCurrentTime(), 150);
+    simRestored.Simulate(timeSim);
+
+    // seek back
+    ASSERT_EQ(sim.RestoreCheckpoint(blob), true);
+    ASSERT_EQ(listBranch[100].IsServiced(), false);
+    sim.Simulate(timeSim);
+
+    int numDifferent = 0;
+    for(unsigned int i=0; i<listRequests.size(); ++i)
+    {
+        numDifferent += listStraight[i].GetArriveTime() != listRestored[i].GetArriveTime();
+        numDifferent += listStraight[i].GetArriveTime() != listBranch[i].GetArriveTime();
+    }
+    ASSERT_EQ(numDifferent, 0);
+    ASSERT_EQ(listStraight[100].IsServiced(), true);
+    ASSERT_EQ(simRestored.GetCurrFloor(), simStraight.GetCurrFloor());
+    ASSERT_EQ(simRestored.GetWaitHistogram().GetCount(), 101L);
+    ASSERT_EQ(simRestored.GetJourneyHistogram().GetPercentile(95), simStraight.GetJourneyHistogram().GetPercentile(95));
+
+    // what-if: one more passenger at time 100 (before the checkpoint: in play at once)
+    vector<ECElevatorSimRequest> listWhatIf(listRequests);
+    listWhatIf.push_back(ECElevatorSimRequest(100, 20, 1));
+    ECElevatorSim simWhatIf(NUM_FLOORS, listWhatIf);
+    ASSERT_EQ(simWhatIf.RestoreCheckpoint(blob), true);
+    simWhatIf.Simulate(timeSim);
+    ASSERT_EQ(listWhatIf[101].IsServiced(), true);
+
+    // not for another building, nor a damaged blob
+    vector<ECElevatorSimRequest> listOther(listRequests);
+    ECElevatorSim simOther(NUM_FLOORS + 1, listOther);
+    ASSERT_EQ(simOther.RestoreCheckpoint(blob), false);
+    // a floor or direction out of range is damage too, though the requests' hash matches:
+    // after the 15 byte header come the time (150: 2 bytes), the floor and the
+    // direction (a byte each, zigzag: twice the value)
+    vector<uint8_t> blobBad(blob);
+    blobBad[17] = 2 * (NUM_FLOORS + 1);
+    ASSERT_EQ(simRestored.RestoreCheckpoint(blobBad), false);
+    blobBad[17] = 0;
+    ASSERT_EQ(simRestored.RestoreCheckpoint(blobBad), false);
+    blobBad = blob;
+    blobBad[18] = 2 * 3;
+    ASSERT_EQ(simRestored.RestoreCheckpoint(blobBad), false);
+    blobBad[18] = blob[18];
+    ASSERT_EQ(blobBad == blob, true);
+    blob.pop_back();
+    ASSERT_EQ(simRestored.RestoreCheckpoint(blob), false);
+    ASSERT_EQ(simRestored.GetCurrentTime(), timeSim);
+}
+
+// Capacity and direction-aware boarding.
+// (a) five passengers in the lobby for floor 5, car for two: three round trips
+// (b) a passenger at floor 3 for the lobby while the car takes another from 1 to 6:
+// boarding by direction, the car passes floor 3 on the way up
+static void Test19()
+{
+    cout << "\n****** TEST 19\n";
+    const int NUM_FLOORS = 7;
+    vector<ECElevatorSimRequest> listLobby;
+    for(int i=0; i<5; ++i)
+    {
+        listLobby.push_back(ECElevatorSimRequest(0, 1, 5));
+    }
+    ECElevatorSim sim(NUM_FLOORS, listLobby);
+    ASSERT_EQ(sim.GetCurrInElevator(), 0);
+    sim.SetCapacity(2);
+    int maxInElevator = 0;
+    for(int t=0; t<40; ++t)
+    {
+        sim.AdvanceOneTick();
+        maxInElevator = max(maxInElevator, sim.GetCurrInElevator());
+    }
+    ASSERT_EQ(maxInElevator, 2);
+    ASSERT_EQ(sim.GetCurrInElevator(), 0);
+    ASSERT_EQ(listLobby[0].GetArriveTime(), 5);
+    ASSERT_EQ(listLobby[1].GetArriveTime(), 5);
+    ASSERT_EQ(listLobby[2].GetArriveTime(), 15);
+    ASSERT_EQ(listLobby[3].GetArriveTime(), 15);
+    ASSERT_EQ(listLobby[4].GetArriveTime(), 25);
+
+    for(bool fByDirection : {false, true})
+    {
+        vector<ECElevatorSimRequest> listRequests;
+        listRequests.push_back(ECElevatorSimRequest(0, 1, 6));
+        listRequests.push_back(ECElevatorSimRequest(1, 3, 1));
+        ECElevatorSim simDir(NUM_FLOORS, listRequests);
+        simDir.SetBoardByDirection(fByDirection);
+        simDir.Simulate(40);
+        ASSERT_EQ(simDir.GetBoardTime(1), fByDirection ? 10 : 3);
+        ASSERT_EQ(listRequests[0].GetArriveTime(), fByDirection ? 6 : 7);
+    }
+}
+
+// Dispatch policies: each serves everybody of a random run; a policy picked at compile
+// time runs the same as the one picked at run time, and the default one as before
+template<class TPolicy>
+static void CheckPolicy(int numFloors, const vector<ECElevatorSimRequest> &listRequests, int timeSim)
+{
+    vector<ECElevatorSimRequest> listStatic(listRequests), listDynamic(listRequests);
+    ECElevatorSimWithPolicy<TPolicy> simStatic(numFloors, listStatic);
+    simStatic.Simulate(timeSim);
+    ECElevatorSim simDynamic(numFloors, listDynamic);
+    simDynamic.SetDispatch(TPolicy::TYPE);
+    simDynamic.Simulate(timeSim);
+    int numServiced = 0, numDifferent = 0;
+    for(unsigned int i=0; i<listRequests.size(); ++i)
+    {
+        numServiced += listStatic[i].IsServiced();
+        numDifferent += listStatic[i].GetArriveTime() != listDynamic[i].GetArriveTime();
+    }
+    cout << ECElevatorGetDispatchName(TPolicy::TYPE) << ": mean wait " << simStatic.GetJourneyHistogram().GetMean() << endl;
+    ASSERT_EQ(simStatic.GetDispatch(), TPolicy::TYPE);
+    ASSERT_EQ(numServiced, (int)listRequests.size());
+    ASSERT_EQ(numDifferent, 0);
+}
+static void Test20()
+{
+    cout << "\n****** TEST 20\n";
+    const int NUM_FLOORS = 12;
+    srand(20);
+    vector<ECElevatorSimRequest> listRequests;
+    for(int i=0; i<60; ++i)
+    {
+        int floorSrc = 1 + rand() % NUM_FLOORS;
+        int floorDest = 1 + rand() % NUM_FLOORS;
+        if( floorDest == floorSrc )
+        {
+            floorDest = floorSrc % NUM_FLOORS + 1;
+        }
+        listRequests.push_back(ECElevatorSimRequest(rand() % 100, floorSrc, floorDest));
+    }
+    CheckPolicy<ECElevatorDefaultPolicy>(NUM_FLOORS, listRequests, 1000);
+    CheckPolicy<ECElevatorLookPolicy>(NUM_FLOORS, listRequests, 1000);
+    CheckPolicy<ECElevatorScanPolicy>(NUM_FLOORS, listRequests, 1000);
+    CheckPolicy<ECElevatorNearestPolicy>(NUM_FLOORS, listRequests, 1000);
+    CheckPolicy<ECElevatorDestinationPolicy>(NUM_FLOORS, listRequests, 1000);
+
+    // Test2 under SCAN: after picking up passenger 1 at floor 4 the car sweeps on to
+    // floor 7 (picking up passenger 2 at floor 5) before turning around
+    vector<ECElevatorSimRequest> listScan;
+    listScan.push_back(ECElevatorSimRequest(2, 4, 1));
+    listScan.push_back(ECElevatorSimRequest(3, 5, 2));
+    ECElevatorSimWithPolicy<ECElevatorScanPolicy> sim(7, listScan);
+    sim.Simulate(30);
+    ASSERT_EQ(listScan[1].GetArriveTime(), 15);
+    ASSERT_EQ(listScan[0].GetArriveTime(), 17);
+}
+
+// Number of floors fixed at compile time: same arrive times as ECElevatorSim, and
+// the floor registers answer as the dynamic index does while the car runs
+template<int NumFloors>
+static void CheckFixedFloors(unsigned int seed)
+{
+    srand(seed);
+    vector<ECElevatorSimRequest> listRequests;
+    for(int i=0; i<300; ++i)
+    {
+        int floorSrc = 1 + rand() % NumFloors;
+        int floorDest = 1 + rand() % NumFloors;
+        if( floorDest == floorSrc )
+        {
+            floorDest = floorSrc % NumFloors + 1;
+        }
+        listRequests.push_back(ECElevatorSimRequest(rand() % 1000, floorSrc, floorDest));
+    }
+    vector<ECElevatorSimRequest> listFixed(listRequests), listDynamic(listRequests);
+    ECElevatorSimT<NumFloors> simFixed(NumFloors, listFixed);
+    ECElevatorSim simDynamic(NumFloors, listDynamic);
+    ASSERT_EQ(simFixed.GetNumFloors(), NumFloors);
+    int numMismatches = 0;
+    for(int t=0; t<3000; ++t)
+    {
+        simFixed.AdvanceOneTick();
+        simDynamic.AdvanceOneTick();
+        const ECElevatorCallIndexT<NumFloors> &callsFixed = simFixed.GetCallIndex();
+        const ECElevatorCallIndex &callsDynamic = simDynamic.GetCallIndex();
+        for(int floor=0; floor<=NumFloors+1; ++floor)
+        {
+            for(bool fCarOnly : {false, true})
+            {
+                numMismatches += callsFixed.HasRequestAbove(floor, fCarOnly) != callsDynamic.HasRequestAbove(floor, fCarOnly);
+                numMismatches += callsFixed.HasRequestBelow(floor, fCarOnly) != callsDynamic.HasRequestBelow(floor, fCarOnly);
+                numMismatches += callsFixed.NearestRequestFloor(floor, fCarOnly) != callsDynamic.NearestRequestFloor(floor, fCarOnly);
+            }
+            numMismatches += callsFixed.HasDestBelow(floor) != callsDynamic.HasDestBelow(floor);
+            numMismatches += callsFixed.NearestDestDistance(floor) != callsDynamic.NearestDestDistance(floor);
+        }
+    }
+    int numServiced = 0, numDifferent = 0;
+    for(unsigned int i=0; i<listRequests.size(); ++i)
+    {
+        numServiced += listFixed[i].IsServiced();
+        numDifferent += listFixed[i].GetArriveTime() != listDynamic[i].GetArriveTime();
+    }
+    ASSERT_EQ(numMismatches, 0);
+    ASSERT_EQ(numServiced, (int)listRequests.size());
+    ASSERT_EQ(numDifferent, 0);
+}
+static void Test21()
+{
+    cout << "\n****** TEST 21\n";
+    CheckFixedFloors<8>(21);
+    CheckFixedFloors<16>(22);
+    CheckFixedFloors<32>(23);
+    CheckFixedFloors<64>(24);
+
+    // a policy fixed at compile time as well
+    vector<ECElevatorSimRequest> listScan;
+    listScan.push_back(ECElevatorSimRequest(2, 4, 1));
+    listScan.push_back(ECElevatorSimRequest(3, 5, 2));
+    ECElevatorSimWithPolicy<ECElevatorScanPolicy, 8> sim(8, listScan);
+    sim.Simulate(30);
+    ASSERT_EQ(listScan[1].GetArriveTime(), 17);
+    ASSERT_EQ(listScan[0].GetArriveTime(), 19);
+}
+
+// Serviced requests retire: the store's scans start at the first request not serviced
+// and still agree with the call index; the index's active list holds exactly the
+// requests in flight
+static void Test22()
+{
+    cout << "\n****** TEST 22\n";
+    const int NUM_FLOORS = 20;
+    const int timeSim = 6000;
+    srand(22);
+    vector<ECElevatorSimRequest> listRequests;
+    for(int i=0; i<2000; ++i)
+    {
+        int floorSrc = 1 + rand() % NUM_FLOORS;
+        int floorDest = 1 + rand() % NUM_FLOORS;
+        if( floorDest == floorSrc )
+        {
+            floorDest = floorSrc % NUM_FLOORS + 1;
+        }
+        listRequests.push_back(ECElevatorSimRequest(i * 2, floorSrc, floorDest));
+    }
+    ECElevatorSim sim(NUM_FLOORS, listRequests);
+    const ECElevatorCallIndex &calls = sim.GetCallIndex();
+    int numMismatches = 0;
+    for(int t=0; t<timeSim; ++t)
+    {
+        sim.AdvanceOneTick();
+        if( t % 50 != 0 )
+        {
+            continue;
+        }
+        ECElevatorRequestStore store(listRequests);
+        int firstLive = 0;
+        while( firstLive < (int)listRequests.size() && listRequests[firstLive].IsServiced() )
+        {
+            ++firstLive;
+        }
+        numMismatches += store.GetFirstLive() != firstLive;
+
+        vector<int> listActive(calls.GetActiveRequests().begin(), calls.GetActiveRequests().end());
+        sort(listActive.begin(), listActive.end());
+        vector<int> listInFlight;
+        for(int id=0; id<(int)listRequests.size(); ++id)
+        {
+            if( calls.IsActive(id) )
+            {
+                listInFlight.push_back(id);
+            }
+        }
+        numMismatches += listActive != listInFlight;
+
+        int currFloor = sim.GetCurrFloor();
+        for(int level = EC_ELEVATOR_SIMD_SCALAR; level <= ECElevatorGetBestSimdLevel(); ++level)
+        {
+            ECElevatorSetSimdLevel((EC_ELEVATOR_SIMD_LEVEL)level);
+            ECElevatorScanResult result;
+            ECElevatorScanRequests(store, currFloor, sim.GetCurrentTime() - 1, result);
+            numMismatches += result.numActive != calls.GetNumActive() || result.nearestFloor != calls.NearestRequestFloor(currFloor) || result.fDestBelow != calls.HasDestBelow(currFloor);
+        }
+    }
+    ECElevatorSetSimdLevel(ECElevatorGetBestSimdLevel());
+    ASSERT_EQ(numMismatches, 0);
+    ASSERT_EQ(calls.IsEmpty(), true);
+
+    // a request serviced again from scratch comes back into the scans
+    ECElevatorRequestStore store(listRequests);
+    ASSERT_EQ(store.GetFirstLive(), (int)listRequests.size());
+    store.SetServiced(70, false);
+    ASSERT_EQ(store.GetFirstLive(), 70);
+    ASSERT_EQ(store.CountPending(listRequests[70].GetTime()), 1);
+}
+
+// Arena: a car and a bank built on an ECElevatorArena only take the arena's chunks
+// from the heap, and run the same as with the default allocator
+static void Test23()
+{
+    cout << "\n****** TEST 23\n";
+    const int NUM_FLOORS = 30;
+    const int timeSim = 3000;
+    srand(23);
+    vector<ECElevatorSimRequest> listRequests;
+    for(int i=0; i<500; ++i)
+    {
+        int floorSrc = 1 + rand() % NUM_FLOORS;
+        int floorDest = 1 + rand() % NUM_FLOORS;
+        if( floorDest == floorSrc )
+        {
+            floorDest = floorSrc % NUM_FLOORS + 1;
+        }
+        listRequests.push_back(ECElevatorSimRequest(i * 3, floorSrc, floorDest));
+    }
+    vector<ECElevatorSimRequest> listHeap = listRequests, listArena = listRequests;
+    vector<ECElevatorSimRequest> listBankHeap = listRequests, listBankArena = listRequests;
+    {
+        ECElevatorSim sim(NUM_FLOORS, listHeap);
+        sim.Simulate(timeSim);
+        ECElevatorBank bank(NUM_FLOORS, 3, listBankHeap);
+        bank.Simulate(timeSim);
+    }
+
+    long numAllocationsBefore = ECElevatorGetNumAllocations();
+    ECElevatorArena arena(256 * 1024);
+    {
+        ECElevatorSim sim(NUM_FLOORS, listArena, true, arena.GetResource());
+        sim.Simulate(timeSim);
+        ECElevatorBank bank(NUM_FLOORS, 3, listBankArena, arena.GetResource());
+        bank.Simulate(timeSim);
+    }
+    ASSERT_EQ(ECElevatorGetNumAllocations() - numAllocationsBefore, (long)arena.GetNumChunks());
+    ASSERT_EQ(arena.GetNumChunks(), 1);
+
+    int numMismatches = 0;
+    for(unsigned int i=0; i<listRequests.size(); ++i)
+    {
+        numMismatches += listHeap[i].GetArriveTime() != listArena[i].GetArriveTime();
+        numMismatches += listBankHeap[i].GetArriveTime() != listBankArena[i].GetArriveTime();
+    }
+    ASSERT_EQ(numMismatches, 0);
+    ASSERT_EQ(listArena[0].IsServiced(), true);
+
+    // released in one go, and ready for the next run
+    arena.Release();
+    ASSERT_EQ(arena.GetNumChunks(), 1);
+    ECElevatorSim sim(NUM_FLOORS, listRequests, true, arena.GetResource());
+    sim.Simulate(timeSim);
+    ASSERT_EQ(listRequests[0].GetArriveTime(), listHeap[0].GetArriveTime());
+}
+
+// Live injection: requests pushed from other threads while the simulation runs are
+// taken in at the next tick and serviced; one injected before a tick runs like the
+// same request made at that time
+static void Test24()
+{
+    cout << "\n****** TEST 24\n";
+    vector<ECElevatorSimRequest> listPreloaded;
+    listPreloaded.push_back(ECElevatorSimRequest(5, 3, 7));
+    ECElevatorSim simPreloaded(10, listPreloaded);
+    simPreloaded.Simulate(40);
+
+    vector<ECElevatorSimRequest> listLive;
+    ECElevatorSim simLive(10, listLive);
+    vector<ECElevatorSimRequest> listArrived;
+    simLive.SetArriveHandler([&listArrived](const ECElevatorSimRequest &request) {
+        listArrived.push_back(request);
+    });
+    ASSERT_EQ(simLive.InjectRequest(3, 7), false);
+    simLive.EnableInjection(4);
+    ASSERT_EQ(simLive.InjectRequest(3, 3), false);
+    ASSERT_EQ(simLive.InjectRequest(0, 7), false);
+    simLive.Simulate(5);
+    ASSERT_EQ(simLive.InjectRequest(3, 7), true);
+    simLive.Simulate(40);
+    // kept by the simulation, not added to the list
+    ASSERT_EQ((int)listLive.size(), 0);
+    ASSERT_EQ((int)listArrived.size(), 1);
+    ASSERT_EQ(listArrived[0].GetTime(), 5);
+    ASSERT_EQ(listArrived[0].GetArriveTime(), listPreloaded[0].GetArriveTime());
+
+    // bounded: a full queue turns pushes away
+    ECElevatorSim simFull(10, listLive);
+    simFull.EnableInjection(4);
+    int numPushed = 0;
+    for(int i=0; i<10; ++i)
+    {
+        numPushed += simFull.InjectRequest(1, 2);
+    }
+    ASSERT_EQ(numPushed, 4);
+
+    // a long session: the slots are reused and taking requests in allocates nothing
+    vector<ECElevatorSimRequest> listLong;
+    ECElevatorSim simLong(10, listLong);
+    int numLongArrived = 0;
+    simLong.SetArriveHandler([&numLongArrived](const ECElevatorSimRequest &) {
+        ++numLongArrived;
+    });
+    simLong.EnableInjection(16);
+    long numAllocsBefore = ECElevatorGetNumAllocations();
+    for(int t=0; t<20000; ++t)
+    {
+        if( t % 10 == 0 )
+        {
+            simLong.InjectRequest(1 + t / 10 % 10, 1 + (t / 10 + 3) % 10);
+        }
+        simLong.AdvanceOneTick();
+    }
+    ASSERT_EQ(ECElevatorGetNumAllocations() - numAllocsBefore, 0L);
+    ASSERT_EQ(numLongArrived > 1900, true);
+    ASSERT_EQ((int)listLong.size(), 0);
+
+    // producers on other threads, the simulation ticking on this one
+    const int NUM_FLOORS = 20;
+    const int NUM_PRODUCERS = 4;
+    const int NUM_PER_PRODUCER = 500;
+    vector<ECElevatorSimRequest> listRequests;
+    ECElevatorSim sim(NUM_FLOORS, listRequests);
+    sim.EnableInjection(64);
+    std::atomic<int> numInjected(0);
+    vector<std::thread> listProducers;
+    for(int p=0; p<NUM_PRODUCERS; ++p)
+    {
+        listProducers.emplace_back([&sim, &numInjected, p]() {
+            unsigned seed = 24 + p;
+            for(int i=0; i<NUM_PER_PRODUCER; )
+            {
+                seed = seed * 1103515245 + 12345;
+                int floorSrc = 1 + (seed >> 8) % NUM_FLOORS;
+                int floorDest = floorSrc % NUM_FLOORS + 1;
+                if( sim.InjectRequest(floorSrc, floorDest) )
+                {
+                    ++i;
+                    ++numInjected;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::atomic<int> numServiced(0);
+    sim.SetArriveHandler([&numServiced](const ECElevatorSimRequest &) {
+        ++numServiced;
+    });
+    // (every request pushed is taken in once the queue is empty)
+    while( numInjected < NUM_PRODUCERS * NUM_PER_PRODUCER || sim.GetCallIndex().GetNumActive() + numServiced < numInjected )
+    {
+        sim.AdvanceOneTick();
+    }
+    for(auto &producer : listProducers)
+    {
+        producer.join();
+    }
+    // let the car clear the building
+    for(int t=0; t<100000 && !sim.GetCallIndex().IsEmpty(); ++t)
+    {
+        sim.AdvanceOneTick();
+    }
+    ASSERT_EQ((int)listRequests.size(), 0);
+    ASSERT_EQ((int)numServiced, NUM_PRODUCERS * NUM_PER_PRODUCER);
+}
+
+// Simulation on its own thread: the snapshots the reader sees come in tick order and
+// add up; the run ends where the same run on this thread does
+static void Test25()
+{
+    cout << "\n****** TEST 25\n";
+    // a reader that never waits gets the values in order and ends on the last one
+    ECElevatorTripleBuffer<int> buffer(0);
+    std::thread writer([&buffer]() {
+        for(int i=1; i<=100000; ++i)
+        {
+            buffer.GetBack() = i;
+            buffer.Publish();
+        }
+    });
+    int numOutOfOrder = 0, last = 0;
+    while( last < 100000 )
+    {
+        buffer.Update();
+        numOutOfOrder += buffer.GetFront() < last;
+        last = buffer.GetFront();
+    }
+    writer.join();
+    ASSERT_EQ(numOutOfOrder, 0);
+    ASSERT_EQ(buffer.Update(), false);
+
+    const int NUM_FLOORS = 15;
+    const int timeSim = 4000;
+    srand(25);
+    vector<ECElevatorSimRequest> listRequests;
+    for(int i=0; i<600; ++i)
+    {
+        int floorSrc = 1 + rand() % NUM_FLOORS;
+        int floorDest = 1 + rand() % NUM_FLOORS;
+        if( floorDest == floorSrc )
+        {
+            floorDest = floorSrc % NUM_FLOORS + 1;
+        }
+        listRequests.push_back(ECElevatorSimRequest(i * 5, floorSrc, floorDest));
+    }
+    vector<ECElevatorSimRequest> listHere = listRequests;
+    ECElevatorSim simHere(NUM_FLOORS, listHere);
+    for(int t=0; t<timeSim; ++t)
+    {
+        simHere.AdvanceOneTick();
+    }
+
+    ECElevatorSim sim(NUM_FLOORS, listRequests);
+    ECElevatorSimRunner runner(sim, timeSim);
+    ASSERT_EQ(runner.GetSnapshot().time, 0);
+    runner.Start();
+    int numBad = 0, lastTime = 0;
+    while( true )
+    {
+        const ECElevatorSnapshot &snapshot = runner.GetSnapshot();
+        numBad += snapshot.time < lastTime;
+        lastTime = snapshot.time;
+        // everyone made so far is waiting, riding or there
+        int numMade = 0;
+        while( numMade < (int)listRequests.size() && listRequests[numMade].GetTime() < snapshot.time )
+        {
+            ++numMade;
+        }
+        int numWaiting = 0;
+        for(int f=0; f<NUM_FLOORS; ++f)
+        {
+            numWaiting += snapshot.listWaitingUp[f] + snapshot.listWaitingDown[f];
+        }
+        numBad += numWaiting + snapshot.numInElevator + snapshot.numServiced != numMade;
+        if( snapshot.fDone )
+        {
+            break;
+        }
+    }
+    runner.Stop();
+    ASSERT_EQ(numBad, 0);
+    ASSERT_EQ(runner.IsDone(), true);
+    ASSERT_EQ(runner.GetSnapshot().time, timeSim);
+    ASSERT_EQ(runner.GetSnapshot().currFloor, simHere.GetCurrFloor());
+    int numMismatches = 0;
+    for(unsigned int i=0; i<listRequests.size(); ++i)
+    {
+        numMismatches += listRequests[i].GetArriveTime() != listHere[i].GetArriveTime();
+    }
+    ASSERT_EQ(numMismatches, 0);
+}
+
+// Streaming compaction: a passenger far up is made to wait the whole run (the car goes for
+// the nearest request and a steady stream of short trips keeps it between floors 1 and 2).
+// The serviced requests are dropped around that one, so the list still stays bounded.
+class ECElevatorShuttleSource : public ECElevatorRequestSource
+{
+public:
+    ECElevatorShuttleSource(int numRequests) : numRequests(numRequests), next(0) {}
+    virtual int PeekTime() { return next < numRequests ? 2 * next : -1; }
+    virtual bool Next(int &time, int &floorSrc, int &floorDest)
+    {
+        if( next >= numRequests )
+        {
+            return false;
+        }
+        time = 2 * next;
+        floorSrc = next == 1 ? 20 : 1 + next % 2;
+        floorDest = next == 1 ? 19 : 2 - next % 2;
+        ++next;
+        return true;
+    }
+private:
+    int numRequests;
+    int next;
+};
+
+static void Test26()
+{
+    cout << "\n****** TEST 26\n";
+    const int NUM_FLOORS = 20;
+    const int numRequests = 20000;
+    ECElevatorShuttleSource source(numRequests);
+    ECElevatorSim sim(NUM_FLOORS, source);
+    sim.SetDispatch(EC_DISPATCH_NEAREST);
+    int numArrived = 0, maxRequests = 0, numFarArrived = 0;
+    sim.SetArriveHandler([&](const ECElevatorSimRequest &request) {
+        ++numArrived;
+        numFarArrived += request.GetFloorSrc() == 20;
+        maxRequests = max(maxRequests, sim.GetNumRequests());
+    });
+    sim.Simulate(2 * numRequests);
+    ASSERT_EQ(numFarArrived, 0);
+    ASSERT_EQ(numArrived > numRequests - 100, true);
+    ASSERT_EQ(maxRequests <= 4096, true);
+    // the one left waiting is still in play, under its new id
+    int numFarWaiting = 0;
+    for(int i=0; i<sim.GetNumRequests(); ++i)
+    {
+        numFarWaiting += sim.GetRequest(i).GetFloorSrc() == 20 && !sim.GetRequest(i).IsServiced() && sim.GetCallIndex().IsActive(i);
+    }
+    ASSERT_EQ(numFarWaiting, 1);
+}
+
+// Binary request files whose record size isn't ours are turned down (the header keeps the size)
+static void Test27()
+{
+    cout << "\n****** TEST 27\n";
+    vector<ECElevatorSimRequest> listRequests;
+    listRequests.push_back(ECElevatorSimRequest(2, 4, 1));
+    listRequests.push_back(ECElevatorSimRequest(3, 2, 5));
+    const char *fileRequests = "ECElevatorTest.requests";
+    ECElevatorWriteRequestFile(fileRequests, listRequests, true);
+    ECElevatorRequestReader reader;
+    ASSERT_EQ(reader.Open(fileRequests), true);
+    reader.Close();
+
+    // a file written with 12 byte records
+    FILE *pFile = fopen(fileRequests, "r+b");
+    uint32_t sizeRecord = 12;
+    fseek(pFile, 4, SEEK_SET);
+    fwrite(&sizeRecord, sizeof(sizeRecord), 1, pFile);
+    fclose(pFile);
+    ASSERT_EQ(reader.Open(fileRequests), false);
+    ASSERT_EQ(reader.IsOpen(), false);
+    vector<ECElevatorSimRequest> listRead;
+    ASSERT_EQ(ECElevatorReadRequestFile(fileRequests, listRead), false);
+    ASSERT_EQ(listRead.size(), (size_t)0);
+
+    // lines that don't fit a record are skipped: floors past int16, numbers past int,
+    // negative times (which would end the replay early)
+    ofstream(fileRequests) << "1,2,3\n2,40000,1\n-5,2,3\n3,99999999999,1\n4,3,2\n";
+    ASSERT_EQ(ECElevatorReadRequestFile(fileRequests, listRead), true);
+    ASSERT_EQ(listRead.size(), (size_t)2);
+    ASSERT_EQ(listRead[1].GetTime(), 4);
+
+    // and the writer won't write them
+    vector<ECElevatorSimRequest> listBig(1, ECElevatorSimRequest(1, 40000, 1));
+    vector<ECElevatorSimRequest> listNegative(1, ECElevatorSimRequest(-1, 2, 1));
+    ASSERT_EQ(ECElevatorWriteRequestFile(fileRequests, listBig, true), false);
+    ASSERT_EQ(ECElevatorWriteRequestFile(fileRequests, listNegative), false);
+    remove(fileRequests);
+}
+
 int main()
 {
     // Test0();
@@ -335,4 +1379,23 @@ int main()
     // Test6();
     // Test7();
     // Test8();
+    Test9();
+    Test10();
+    Test11();
+    Test12();
+    Test13();
+    Test14();
+    Test15();
+    Test16();
+    Test17();
+    Test18();
+    Test19();
+    Test20();
+    Test21();
+    Test22();
+    Test23();
+    Test24();
+    Test25();
+    Test26();
+    Test27();
 }
@@ -0,0 +1,100 @@
+#include "ECElevatorThreadPool.h"
+
+using namespace std;
+
+ECElevatorThreadPool :: ECElevatorThreadPool(int numThreads) : pTask(NULL), batchId(0), numPending(0), numBusy(0), fStop(false) {
+  if (numThreads <= 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (int i = 0; i < numThreads; ++i) {
+    listQueues.emplace_back(new TaskQueue());
+  }
+  for (int i = 0; i < numThreads; ++i) {
+    listThreads.emplace_back(&ECElevatorThreadPool::WorkerLoop, this, i);
+  }
+}
+ECElevatorThreadPool :: ~ECElevatorThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mtxBatch);
+    fStop = true;
+  }
+  cvBatch.notify_all();
+  for (auto &thread : listThreads) {
+    thread.join();
+  }
+}
+
+int ECElevatorThreadPool::GetNumThreads() const {
+  return listThreads.size();
+}
+
+void ECElevatorThreadPool::ParallelFor(int numTasks, const std::function<void(int)> &task) {
+  if (numTasks <= 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mtxBatch);
+  // deal tasks out round robin
+  for (int i = 0; i < numTasks; ++i) {
+    TaskQueue &queue = *listQueues[i % listQueues.size()];
+    std::lock_guard<std::mutex> lockQueue(queue.mtx);
+    queue.tasks.push_back(i);
+  }
+  pTask = &task;
+  numPending = numTasks;
+  ++batchId;
+  cvBatch.notify_all();
+  // wait until the tasks are done and no worker holds on to this batch any more
+  cvDone.wait(lock, [this] { return numPending.load() == 0 && numBusy == 0; });
+  pTask = NULL;
+}
+
+void ECElevatorThreadPool::WorkerLoop(int worker) {
+  long batchSeen = 0;
+  while (true) {
+    const std::function<void(int)> *pTaskCurr;
+    {
+      std::unique_lock<std::mutex> lock(mtxBatch);
+      cvBatch.wait(lock, [this, batchSeen] { return fStop || batchId != batchSeen; });
+      if (fStop) {
+        return;
+      }
+      batchSeen = batchId;
+      pTaskCurr = pTask;
+      if (pTaskCurr == NULL) {
+        // woke up after the batch was over
+        continue;
+      }
+      ++numBusy;
+    }
+    int task;
+    while (PopOrSteal(worker, task)) {
+      (*pTaskCurr)(task);
+      --numPending;
+    }
+    std::lock_guard<std::mutex> lock(mtxBatch);
+    --numBusy;
+    cvDone.notify_all();
+  }
+}
+
+bool ECElevatorThreadPool::PopOrSteal(int worker, int &task) {
+  {
+    TaskQueue &own = *listQueues[worker];
+    std::lock_guard<std::mutex> lock(own.mtx);
+    if (!own.tasks.empty()) {
+      task = own.tasks.front();
+      own.tasks.pop_front();
+      return true;
+    }
+  }
+  for (unsigned int i = 1; i < listQueues.size(); ++i) {
+    TaskQueue &victim = *listQueues[(worker + i) % listQueues.size()];
+    std::lock_guard<std::mutex> lock(victim.mtx);
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.back();
+      victim.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,55 @@
+#ifndef ECElevatorThreadPool_h
+#define ECElevatorThreadPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//*****************************************************************************
+// Work stealing thread pool
+//
+// ParallelFor deals the tasks out to the workers' own queues; a worker takes
+// from the front of its queue and, once that is empty, steals from the back of
+// the others' queues, so long tasks on one worker don't leave the rest idle.
+
+class ECElevatorThreadPool
+{
+public:
+    // numThreads <= 0: one thread per core
+    explicit ECElevatorThreadPool(int numThreads = 0);
+    ~ECElevatorThreadPool();
+
+    int GetNumThreads() const;
+
+    // Run task(0), ..., task(numTasks-1) on the pool; return when all are done
+    void ParallelFor(int numTasks, const std::function<void(int)> &task);
+
+private:
+    void WorkerLoop(int worker);
+    bool PopOrSteal(int worker, int &task);
+
+    struct TaskQueue
+    {
+        std::mutex mtx;
+        std::deque<int> tasks;
+    };
+    std::vector<std::unique_ptr<TaskQueue>> listQueues;
+    std::vector<std::thread> listThreads;
+
+    // current batch
+    std::mutex mtxBatch;
+    std::condition_variable cvBatch;
+    std::condition_variable cvDone;
+    const std::function<void(int)> *pTask;
+    long batchId;
+    std::atomic<int> numPending;
+    int numBusy;        // workers working on the current batch
+    bool fStop;
+};
+
+#endif /* ECElevatorThreadPool_h */
@@ -0,0 +1,84 @@
+#include "ECElevatorTrace.h"
+#include "ECElevatorSim.h"
+#include <chrono>
+
+using namespace std;
+
+ECElevatorTraceSink :: ECElevatorTraceSink(const std::string &fileName, int levelIn, size_t capacity) : pFile(NULL), level(levelIn), ringRecords(capacity), numRecorded(0), numDropped(0), numWritten(0), fStop(false) {
+  pFile = fopen(fileName.c_str(), "w");
+  if (pFile == NULL) {
+    cout << "Warning: cannot open trace file " << fileName << endl;
+    level = EC_TRACE_NONE;
+    return;
+  }
+  threadDrain = std::thread(&ECElevatorTraceSink::Drain, this);
+}
+ECElevatorTraceSink :: ~ECElevatorTraceSink() {
+  fStop = true;
+  if (threadDrain.joinable()) {
+    threadDrain.join();
+  }
+  if (pFile != NULL) {
+    fclose(pFile);
+  }
+}
+
+void ECElevatorTraceSink::Flush() {
+  if (pFile == NULL) {
+    return;
+  }
+  while (numWritten.load() < numRecorded.load()) {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  fflush(pFile);
+}
+
+// background thread: write out records until stopped, then whatever is left
+void ECElevatorTraceSink::Drain() {
+  ECElevatorTraceRecord rec;
+  while (true) {
+    bool fStopping = fStop.load();
+    bool fAny = false;
+    while (ringRecords.TryPop(rec)) {
+      Write(rec);
+      fAny = true;
+    }
+    if (fStopping) {
+      break;
+    }
+    if (!fAny) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+}
+
+void ECElevatorTraceSink::Write(const ECElevatorTraceRecord &rec) {
+  static const char *stateNames[] = {"Stop", "Moving", "StopOver", "Maintenance"};
+  switch (rec.event) {
+    case EC_TRACE_EV_TICK:
+      fprintf(pFile, "Time: %d, Floor: %d, Dir: %d\n", rec.time, rec.floor, rec.a);
+      break;
+    case EC_TRACE_EV_NEW_REQUEST:
+      fprintf(pFile, "Time: %d, New request: From floor %d to floor %d\n", rec.time, rec.floor, rec.a);
+      break;
+    case EC_TRACE_EV_BOARD:
+      fprintf(pFile, "Time: %d, Passenger %d boarded at floor %d\n", rec.time, rec.a, rec.floor);
+      break;
+    case EC_TRACE_EV_ARRIVE:
+      fprintf(pFile, "Time: %d, Passenger %d arrived at floor %d\n", rec.time, rec.a, rec.floor);
+      break;
+    case EC_TRACE_EV_STATE:
+      fprintf(pFile, "Time: %d, State changed to: %s\n", rec.time, (rec.a >= 0 && rec.a < 4) ? stateNames[rec.a] : "?");
+      break;
+    case EC_TRACE_EV_IDLE:
+      fprintf(pFile, "Time: %d, Idle: skipping to time %d\n", rec.time, rec.a);
+      break;
+    case EC_TRACE_EV_STOPPED:
+      fprintf(pFile, "Time: %d, Elevator has stopped due to no pending requests.\n", rec.time);
+      break;
+    default:
+      fprintf(pFile, "Time: %d, Event %d: %d %d\n", rec.time, rec.event, rec.floor, rec.a);
+      break;
+  }
+  numWritten.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,118 @@
+#ifndef ECElevatorTrace_h
+#define ECElevatorTrace_h
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "ECElevatorRingBuffer.h"
+
+//*****************************************************************************
+// Trace levels
+//
+// EC_TRACE_LEVEL (compile time) is the most detailed level compiled in; anything
+// above it costs nothing. By default tracing is compiled out of release (NDEBUG)
+// builds. Below that, a sink has its own level that can be changed at run time.
+
+enum EC_TRACE_LEVEL_TYPE
+{
+    EC_TRACE_NONE = 0,      // quiet
+    EC_TRACE_PASSENGER = 1, // passengers board/arrive
+    EC_TRACE_STATE = 2,     // new requests, state changes, idle skips
+    EC_TRACE_TICK = 3       // status of the elevator every tick
+};
+
+#ifndef EC_TRACE_LEVEL
+#ifdef NDEBUG
+#define EC_TRACE_LEVEL 0
+#else
+#define EC_TRACE_LEVEL 3
+#endif
+#endif
+
+//*****************************************************************************
+// Trace events: one fixed size record each
+
+enum EC_TRACE_EVENT
+{
+    EC_TRACE_EV_TICK = 0,       // floor: current floor, a: direction
+    EC_TRACE_EV_NEW_REQUEST,    // floor: floorSrc, a: floorDest
+    EC_TRACE_EV_BOARD,          // floor: current floor, a: request id
+    EC_TRACE_EV_ARRIVE,         // floor: current floor, a: request id
+    EC_TRACE_EV_STATE,          // floor: current floor, a: new state (EC_ELEVATOR_STATE_TYPE)
+    EC_TRACE_EV_IDLE,           // floor: current floor, a: time skipped to
+    EC_TRACE_EV_STOPPED         // floor: current floor; no pending requests
+};
+
+struct ECElevatorTraceRecord
+{
+    int32_t time;
+    int16_t event;
+    int16_t floor;
+    int32_t a;
+};
+
+//*****************************************************************************
+// Trace sink: records go into a preallocated ring; a background thread drains
+// them into a file (one text line per record). Recording never blocks: when the
+// ring is full the record is dropped (and counted).
+
+class ECElevatorTraceSink
+{
+public:
+    ECElevatorTraceSink(const std::string &fileName, int level = EC_TRACE_TICK, size_t capacity = 1 << 16);
+    ~ECElevatorTraceSink();
+
+    // run-time level
+    int GetLevel() const { return level.load(std::memory_order_relaxed); }
+    void SetLevel(int l) { level.store(l, std::memory_order_relaxed); }
+    bool IsEnabled(int l) const { return l <= GetLevel(); }
+
+    // Record an event (any thread)
+    void Record(int time, int event, int floor, int a)
+    {
+        ECElevatorTraceRecord rec = {time, (int16_t)event, (int16_t)floor, a};
+        if( ringRecords.TryPush(rec) )
+        {
+            numRecorded.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Wait until everything recorded so far is written out
+    void Flush();
+
+    bool IsOpen() const { return pFile != NULL; }
+    long GetNumRecorded() const { return numRecorded.load(); }
+    long GetNumDropped() const { return numDropped.load(); }
+    long GetNumWritten() const { return numWritten.load(); }
+
+private:
+    void Drain();
+    void Write(const ECElevatorTraceRecord &rec);
+
+    FILE *pFile;
+    std::atomic<int> level;
+    ECElevatorRingBuffer<ECElevatorTraceRecord> ringRecords;
+    std::atomic<long> numRecorded;
+    std::atomic<long> numDropped;
+    std::atomic<long> numWritten;
+    std::atomic<bool> fStop;
+    std::thread threadDrain;
+};
+
+//*****************************************************************************
+// Trace an event to a sink (may be NULL) if both compile time and run time levels allow it
+
+#if EC_TRACE_LEVEL > 0
+#define EC_TRACE(pSink, lvl, time, event, floor, a) \
+    do { if( (lvl) <= EC_TRACE_LEVEL && (pSink) != NULL && (pSink)->IsEnabled(lvl) ) (pSink)->Record((time), (event), (floor), (a)); } while(0)
+#else
+#define EC_TRACE(pSink, lvl, time, event, floor, a) do { } while(0)
+#endif
+
+#endif /* ECElevatorTrace_h */
@@ -0,0 +1,63 @@
+#include "ECElevatorTraffic.h"
+#include <cstring>
+#include <random>
+
+using namespace std;
+
+static const char *trafficNames[EC_TRAFFIC_NUM_PATTERNS] = {"up-peak", "down-peak", "lunch", "inter-floor"};
+
+const char *ECElevatorGetTrafficName(EC_TRAFFIC_PATTERN pattern) {
+  return trafficNames[pattern];
+}
+
+int ECElevatorFindTrafficPattern(const char *name) {
+  for (int p = 0; p < EC_TRAFFIC_NUM_PATTERNS; ++p) {
+    if (strcmp(name, trafficNames[p]) == 0) {
+      return p;
+    }
+  }
+  return -1;
+}
+
+void ECElevatorGenerateTraffic(EC_TRAFFIC_PATTERN pattern, int numFloors, int numRequests, double requestsPerTick, unsigned seed, std::vector<ECElevatorSimRequest> &listRequests) {
+  const int LOBBY = 1;
+  mt19937 rng(seed);
+  exponential_distribution<double> gap(requestsPerTick);
+  uniform_int_distribution<int> anyFloor(1, numFloors);
+  uniform_int_distribution<int> upperFloor(2, numFloors);
+  uniform_real_distribution<double> coin(0.0, 1.0);
+
+  listRequests.clear();
+  listRequests.reserve(numRequests);
+  double time = 0.0;
+  for (int i = 0; i < numRequests; ++i) {
+    time += gap(rng);
+    double p = coin(rng);
+    int floorSrc, floorDest;
+    if (pattern == EC_TRAFFIC_UP_PEAK && p < 0.85) {
+      floorSrc = LOBBY;
+      floorDest = upperFloor(rng);
+    }
+    else if (pattern == EC_TRAFFIC_DOWN_PEAK && p < 0.85) {
+      floorSrc = upperFloor(rng);
+      floorDest = LOBBY;
+    }
+    else if (pattern == EC_TRAFFIC_LUNCH && p < 0.45) {
+      floorSrc = upperFloor(rng);
+      floorDest = LOBBY;
+    }
+    else if (pattern == EC_TRAFFIC_LUNCH && p < 0.9) {
+      floorSrc = LOBBY;
+      floorDest = upperFloor(rng);
+    }
+    else {
+      // inter-floor trip
+      floorSrc = anyFloor(rng);
+      floorDest = anyFloor(rng);
+      while (floorDest == floorSrc) {
+        floorDest = anyFloor(rng);
+      }
+    }
+    listRequests.push_back(ECElevatorSimRequest((int)time, floorSrc, floorDest));
+  }
+}
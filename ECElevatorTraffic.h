@@ -0,0 +1,32 @@
+#ifndef ECElevatorTraffic_h
+#define ECElevatorTraffic_h
+
+#include <vector>
+#include "ECElevatorSim.h"
+
+//*****************************************************************************
+// Synthetic traffic for benchmarks
+//
+// Requests arrive at random (on average requestsPerTick of them per tick) and
+// come out sorted by time. Floor 1 is the lobby:
+//   up-peak      morning: mostly lobby -> upper floors
+//   down-peak    evening: mostly upper floors -> lobby
+//   lunch        half to the lobby, half from it
+//   inter-floor  any floor to any other floor
+
+typedef enum
+{
+    EC_TRAFFIC_UP_PEAK = 0,
+    EC_TRAFFIC_DOWN_PEAK,
+    EC_TRAFFIC_LUNCH,
+    EC_TRAFFIC_INTER_FLOOR,
+    EC_TRAFFIC_NUM_PATTERNS
+} EC_TRAFFIC_PATTERN;
+
+const char *ECElevatorGetTrafficName(EC_TRAFFIC_PATTERN pattern);
+// -1 if the name is unknown
+int ECElevatorFindTrafficPattern(const char *name);
+
+void ECElevatorGenerateTraffic(EC_TRAFFIC_PATTERN pattern, int numFloors, int numRequests, double requestsPerTick, unsigned seed, std::vector<ECElevatorSimRequest> &listRequests);
+
+#endif /* ECElevatorTraffic_h */
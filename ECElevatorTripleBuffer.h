@@ -0,0 +1,58 @@
+#ifndef ECElevatorTripleBuffer_h
+#define ECElevatorTripleBuffer_h
+
+#include <atomic>
+
+//*****************************************************************************
+// Lock-free triple buffer: one writer hands the latest value to one reader
+//
+// The writer fills its back slot and publishes it; the reader takes the newest
+// published slot when it wants one. The third slot sits between the two, so
+// neither side ever waits for the other: the writer can publish any number of
+// times while the reader holds its slot (values in between are dropped), and the
+// reader keeps its slot until it asks for a newer one.
+// The writer gets back an older slot after each publish: overwrite all of it.
+
+template<class T>
+class ECElevatorTripleBuffer
+{
+public:
+    // every slot starts as a copy of init (e.g., to size its arrays once)
+    explicit ECElevatorTripleBuffer(const T &init = T()) : slots{init, init, init}, indexBack(0), indexFront(2), stateMiddle(1)
+    {
+    }
+    ECElevatorTripleBuffer(const ECElevatorTripleBuffer &) = delete;
+    ECElevatorTripleBuffer& operator=(const ECElevatorTripleBuffer &) = delete;
+
+    // Writer: the slot to fill, then publish it
+    T& GetBack() { return slots[indexBack]; }
+    void Publish()
+    {
+        indexBack = stateMiddle.exchange(indexBack | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Reader: take the newest published slot if there is one; return false if nothing
+    // was published since the last call
+    bool Update()
+    {
+        if( (stateMiddle.load(std::memory_order_relaxed) & FRESH) == 0 )
+        {
+            return false;
+        }
+        indexFront = stateMiddle.exchange(indexFront, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T& GetFront() const { return slots[indexFront]; }
+
+private:
+    // middle slot index, and whether it holds a value the reader hasn't taken
+    static const int INDEX = 3;
+    static const int FRESH = 4;
+
+    T slots[3];
+    int indexBack;      // writer only
+    int indexFront;     // reader only
+    alignas(64) std::atomic<int> stateMiddle;
+};
+
+#endif /* ECElevatorTripleBuffer_h */
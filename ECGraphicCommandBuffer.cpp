@@ -0,0 +1,340 @@
+#include "ECGraphicCommandBuffer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+ECGraphicCommandBuffer :: ECGraphicCommandBuffer()
+{
+    listCommands.reserve(1024);
+    listLevels.reserve(64);
+    listVertices.reserve(16384);
+    listBatch.reserve(16384);
+    listChars.reserve(4096);
+}
+
+//***********************************************************
+// Recording
+
+void ECGraphicCommandBuffer :: AddFilledRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color, int colorKey)
+{
+    Command cmd;
+    BeginShape(cmd, color, colorKey);
+    AddQuad(x1, y1, x2, y1, x2, y2, x1, y2, color);
+    EndShape(cmd, Box{min(x1, x2), min(y1, y2), max(x1, x2), max(y1, y2)});
+}
+
+void ECGraphicCommandBuffer :: AddRectangle(float x1, float y1, float x2, float y2, float thickness, ALLEGRO_COLOR color, int colorKey)
+{
+    // four bands centered on the edges, as al_draw_rectangle
+    float h = max(thickness, 1.0f) / 2;
+    Command cmd;
+    BeginShape(cmd, color, colorKey);
+    AddQuad(x1 - h, y1 - h, x2 + h, y1 - h, x2 + h, y1 + h, x1 - h, y1 + h, color);
+    AddQuad(x1 - h, y2 - h, x2 + h, y2 - h, x2 + h, y2 + h, x1 - h, y2 + h, color);
+    AddQuad(x1 - h, y1 + h, x1 + h, y1 + h, x1 + h, y2 - h, x1 - h, y2 - h, color);
+    AddQuad(x2 - h, y1 + h, x2 + h, y1 + h, x2 + h, y2 - h, x2 - h, y2 - h, color);
+    EndShape(cmd, Box{min(x1, x2) - h, min(y1, y2) - h, max(x1, x2) + h, max(y1, y2) + h});
+}
+
+void ECGraphicCommandBuffer :: AddLine(float x1, float y1, float x2, float y2, float thickness, ALLEGRO_COLOR color, int colorKey)
+{
+    float h = max(thickness, 1.0f) / 2;
+    float dx = x2 - x1, dy = y2 - y1;
+    float len = sqrtf(dx * dx + dy * dy);
+    // normal of the line, half the thickness long
+    float nx = (len > 0) ? -dy / len * h : 0, ny = (len > 0) ? dx / len * h : h;
+    Command cmd;
+    BeginShape(cmd, color, colorKey);
+    AddQuad(x1 + nx, y1 + ny, x2 + nx, y2 + ny, x2 - nx, y2 - ny, x1 - nx, y1 - ny, color);
+    EndShape(cmd, Box{min(x1, x2) - h, min(y1, y2) - h, max(x1, x2) + h, max(y1, y2) + h});
+}
+
+void ECGraphicCommandBuffer :: AddFilledEllipse(float cx, float cy, float rx, float ry, ALLEGRO_COLOR color, int colorKey)
+{
+    int numSegments = GetNumSegments(rx, ry);
+    Command cmd;
+    BeginShape(cmd, color, colorKey);
+    float xPrev = cx + rx, yPrev = cy;
+    for( int i = 1; i <= numSegments; ++i )
+    {
+        float angle = 2 * (float)M_PI * i / numSegments;
+        float x = cx + rx * cosf(angle), y = cy + ry * sinf(angle);
+        AddVertex(cx, cy, color);
+        AddVertex(xPrev, yPrev, color);
+        AddVertex(x, y, color);
+        xPrev = x;
+        yPrev = y;
+    }
+    EndShape(cmd, Box{cx - rx, cy - ry, cx + rx, cy + ry});
+}
+
+void ECGraphicCommandBuffer :: AddEllipse(float cx, float cy, float rx, float ry, float thickness, ALLEGRO_COLOR color, int colorKey)
+{
+    // a ring the thickness wide, centered on the outline
+    float h = max(thickness, 1.0f) / 2;
+    int numSegments = GetNumSegments(rx, ry);
+    Command cmd;
+    BeginShape(cmd, color, colorKey);
+    float cosPrev = 1, sinPrev = 0;
+    for( int i = 1; i <= numSegments; ++i )
+    {
+        float angle = 2 * (float)M_PI * i / numSegments;
+        float c = cosf(angle), s = sinf(angle);
+        AddQuad(cx + (rx - h) * cosPrev, cy + (ry - h) * sinPrev, cx + (rx + h) * cosPrev, cy + (ry + h) * sinPrev,
+                cx + (rx + h) * c, cy + (ry + h) * s, cx + (rx - h) * c, cy + (ry - h) * s, color);
+        cosPrev = c;
+        sinPrev = s;
+    }
+    EndShape(cmd, Box{cx - rx - h, cy - ry - h, cx + rx + h, cy + ry + h});
+}
+
+void ECGraphicCommandBuffer :: AddFilledTriangle(float x1, float y1, float x2, float y2, float x3, float y3, ALLEGRO_COLOR color, int colorKey)
+{
+    Command cmd;
+    BeginShape(cmd, color, colorKey);
+    AddVertex(x1, y1, color);
+    AddVertex(x2, y2, color);
+    AddVertex(x3, y3, color);
+    EndShape(cmd, Box{min({x1, x2, x3}), min({y1, y2, y3}), max({x1, x2, x3}), max({y1, y2, y3})});
+}
+
+void ECGraphicCommandBuffer :: AddTriangle(float x1, float y1, float x2, float y2, float x3, float y3, float thickness, ALLEGRO_COLOR color, int colorKey)
+{
+    // one ring the thickness wide, centered on the edges; the bands meet in mitred
+    // corners (as al_draw_triangle), so three separate lines would leave notches
+    float h = max(thickness, 1.0f) / 2;
+    float xs[3] = {x1, x2, x3}, ys[3] = {y1, y2, y3};
+    // unit normal of each edge i -> i+1
+    float nxs[3], nys[3];
+    for( int i = 0; i < 3; ++i )
+    {
+        float dx = xs[(i + 1) % 3] - xs[i], dy = ys[(i + 1) % 3] - ys[i];
+        float len = sqrtf(dx * dx + dy * dy);
+        nxs[i] = (len > 0) ? -dy / len : 0;
+        nys[i] = (len > 0) ? dx / len : 1;
+    }
+    // corner i is where the offset edges meet: along the sum s of the normals of the
+    // two edges (|s| = 2 cos(half the turn)), h / cos(half the turn) away; very
+    // sharp corners are cut at 4h
+    float xOut[3], yOut[3], xIn[3], yIn[3];
+    Box box{xs[0], ys[0], xs[0], ys[0]};
+    for( int i = 0; i < 3; ++i )
+    {
+        int prev = (i + 2) % 3;
+        float sx = nxs[prev] + nxs[i], sy = nys[prev] + nys[i];
+        float lenS = sqrtf(sx * sx + sy * sy);
+        if( lenS < 1e-3f )
+        {
+            // the edges double back (a flat triangle): no corner to speak of
+            sx = 2 * nxs[i];
+            sy = 2 * nys[i];
+            lenS = 2;
+        }
+        float scale = min(2 * h / lenS, 4 * h) / lenS;
+        float mx = sx * scale, my = sy * scale;
+        xOut[i] = xs[i] + mx;
+        yOut[i] = ys[i] + my;
+        xIn[i] = xs[i] - mx;
+        yIn[i] = ys[i] - my;
+        box.x1 = min({box.x1, xOut[i], xIn[i]});
+        box.y1 = min({box.y1, yOut[i], yIn[i]});
+        box.x2 = max({box.x2, xOut[i], xIn[i]});
+        box.y2 = max({box.y2, yOut[i], yIn[i]});
+    }
+    Command cmd;
+    BeginShape(cmd, color, colorKey);
+    for( int i = 0; i < 3; ++i )
+    {
+        int next = (i + 1) % 3;
+        AddQuad(xOut[i], yOut[i], xOut[next], yOut[next], xIn[next], yIn[next], xIn[i], yIn[i], color);
+    }
+    EndShape(cmd, box);
+}
+
+void ECGraphicCommandBuffer :: AddText(const ALLEGRO_FONT *font, float x, float y, float lineHeight, const char *text, ALLEGRO_COLOR color, int colorKey)
+{
+    Command cmd;
+    cmd.kind = KIND_TEXT;
+    cmd.key = colorKey;
+    cmd.color = color;
+    cmd.font = font;
+    cmd.bitmap = NULL;
+    cmd.x = x;
+    cmd.y = y;
+    cmd.begin = listChars.size();
+    size_t len = strlen(text);
+    listChars.insert(listChars.end(), text, text + len + 1);
+    cmd.end = listChars.size();
+    // no glyph is wider than the line is high
+    float halfWidth = len * lineHeight / 2;
+    cmd.box = Box{x - halfWidth, y, x + halfWidth, y + lineHeight};
+    AddCommand(cmd);
+}
+
+void ECGraphicCommandBuffer :: AddBitmapRegion(ALLEGRO_BITMAP *bitmap, int bitmapKey, float x1, float y1, float x2, float y2)
+{
+    Command cmd;
+    cmd.kind = KIND_BITMAP;
+    cmd.key = bitmapKey;
+    cmd.font = NULL;
+    cmd.bitmap = bitmap;
+    cmd.begin = cmd.end = 0;
+    cmd.box = Box{x1, y1, x2, y2};
+    AddCommand(cmd);
+}
+
+void ECGraphicCommandBuffer :: BeginShape(Command &cmd, ALLEGRO_COLOR color, int colorKey)
+{
+    cmd.kind = KIND_SHAPE;
+    cmd.key = colorKey;
+    cmd.color = color;
+    cmd.font = NULL;
+    cmd.bitmap = NULL;
+    cmd.begin = listVertices.size();
+}
+
+void ECGraphicCommandBuffer :: EndShape(Command &cmd, const Box &box)
+{
+    cmd.end = listVertices.size();
+    cmd.box = box;
+    AddCommand(cmd);
+}
+
+void ECGraphicCommandBuffer :: AddCommand(Command &cmd)
+{
+    // above everything of another kind or key it covers
+    cmd.level = 0;
+    for( const auto &entry : listLevels )
+    {
+        if( entry.level >= cmd.level && (entry.kind != cmd.kind || entry.key != cmd.key) && entry.box.Overlaps(cmd.box) )
+        {
+            cmd.level = entry.level + 1;
+        }
+    }
+    bool fMerged = false;
+    for( auto &entry : listLevels )
+    {
+        if( entry.level == cmd.level && entry.kind == cmd.kind && entry.key == cmd.key )
+        {
+            entry.box = Box{min(entry.box.x1, cmd.box.x1), min(entry.box.y1, cmd.box.y1), max(entry.box.x2, cmd.box.x2), max(entry.box.y2, cmd.box.y2)};
+            fMerged = true;
+            break;
+        }
+    }
+    if( !fMerged )
+    {
+        LevelEntry entry{cmd.level, cmd.kind, cmd.key, cmd.box};
+        listLevels.insert(std::upper_bound(listLevels.begin(), listLevels.end(), entry, [](const LevelEntry &a, const LevelEntry &b) { return a.level < b.level; }), entry);
+    }
+    cmd.seq = listCommands.size();
+    listCommands.push_back(cmd);
+}
+
+void ECGraphicCommandBuffer :: AddVertex(float x, float y, ALLEGRO_COLOR color)
+{
+    ALLEGRO_VERTEX v;
+    v.x = x;
+    v.y = y;
+    v.z = 0;
+    v.u = 0;
+    v.v = 0;
+    v.color = color;
+    listVertices.push_back(v);
+}
+
+void ECGraphicCommandBuffer :: AddQuad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, ALLEGRO_COLOR color)
+{
+    AddVertex(x1, y1, color);
+    AddVertex(x2, y2, color);
+    AddVertex(x3, y3, color);
+    AddVertex(x1, y1, color);
+    AddVertex(x3, y3, color);
+    AddVertex(x4, y4, color);
+}
+
+int ECGraphicCommandBuffer :: GetNumSegments(float rx, float ry)
+{
+    // as Allegro's own ellipses (ALLEGRO_PRIM_QUALITY 10)
+    return max(8, (int)(10 * sqrtf((rx + ry) / 2)));
+}
+
+//***********************************************************
+// Drawing
+
+int ECGraphicCommandBuffer :: Flush()
+{
+    if( listCommands.empty() )
+    {
+        return 0;
+    }
+    // by level, then bitmaps, shapes, text, each by key; ties in recorded order
+    std::sort(listCommands.begin(), listCommands.end(), [](const Command &a, const Command &b) {
+        if( a.level != b.level )
+        {
+            return a.level < b.level;
+        }
+        if( a.kind != b.kind )
+        {
+            return a.kind < b.kind;
+        }
+        if( a.key != b.key )
+        {
+            return a.key < b.key;
+        }
+        return a.seq < b.seq;
+    });
+
+    int numCalls = 0;
+    listBatch.clear();
+    auto flushShapes = [this, &numCalls]() {
+        if( !listBatch.empty() )
+        {
+            al_draw_prim(listBatch.data(), NULL, NULL, 0, listBatch.size(), ALLEGRO_PRIM_TRIANGLE_LIST);
+            listBatch.clear();
+            ++numCalls;
+        }
+    };
+    size_t i = 0;
+    while( i < listCommands.size() )
+    {
+        const Command &cmd = listCommands[i];
+        if( cmd.kind == KIND_SHAPE )
+        {
+            // shapes of consecutive levels go in the same array, in order
+            listBatch.insert(listBatch.end(), listVertices.begin() + cmd.begin, listVertices.begin() + cmd.end);
+            ++i;
+            continue;
+        }
+        flushShapes();
+        // a run of text or bitmaps: one held batch
+        int kind = cmd.kind;
+        al_hold_bitmap_drawing(true);
+        for( ; i < listCommands.size() && listCommands[i].kind == kind; ++i )
+        {
+            const Command &run = listCommands[i];
+            if( kind == KIND_TEXT )
+            {
+                al_draw_text(run.font, run.color, run.x, run.y, ALLEGRO_ALIGN_CENTER, &listChars[run.begin]);
+            }
+            else
+            {
+                al_draw_bitmap_region(run.bitmap, run.box.x1, run.box.y1, run.box.x2 - run.box.x1, run.box.y2 - run.box.y1, run.box.x1, run.box.y1, 0);
+            }
+        }
+        al_hold_bitmap_drawing(false);
+        ++numCalls;
+    }
+    flushShapes();
+    Clear();
+    return numCalls;
+}
+
+void ECGraphicCommandBuffer :: Clear()
+{
+    listCommands.clear();
+    listLevels.clear();
+    listVertices.clear();
+    listChars.clear();
+}
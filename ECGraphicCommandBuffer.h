@@ -0,0 +1,98 @@
+#ifndef ECGraphicCommandBuffer_h
+#define ECGraphicCommandBuffer_h
+
+#include <vector>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_primitives.h>
+
+//***********************************************************
+// Command buffer of drawing primitives
+//
+// The view records its draw calls here during a frame and draws them in one go
+// (Flush): every shape becomes triangles of one vertex array, drawn with as few
+// al_draw_prim calls as possible; text and layer copies are drawn with bitmap
+// drawing held, so Allegro batches the glyphs and copies as well.
+// Commands are grouped by type and color. Reordering must not change the picture:
+// a command that overlaps an earlier one of another type or color is drawn after
+// it (on a higher level); commands that don't overlap (or look the same in either
+// order) may go in any order. Buffers are kept across frames: after the first
+// frames, recording allocates nothing.
+
+class ECGraphicCommandBuffer
+{
+public:
+    ECGraphicCommandBuffer();
+
+    // colorKey: identifies color (same key, same color)
+    void AddFilledRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color, int colorKey);
+    void AddRectangle(float x1, float y1, float x2, float y2, float thickness, ALLEGRO_COLOR color, int colorKey);
+    void AddLine(float x1, float y1, float x2, float y2, float thickness, ALLEGRO_COLOR color, int colorKey);
+    void AddFilledEllipse(float cx, float cy, float rx, float ry, ALLEGRO_COLOR color, int colorKey);
+    void AddEllipse(float cx, float cy, float rx, float ry, float thickness, ALLEGRO_COLOR color, int colorKey);
+    void AddFilledTriangle(float x1, float y1, float x2, float y2, float x3, float y3, ALLEGRO_COLOR color, int colorKey);
+    void AddTriangle(float x1, float y1, float x2, float y2, float x3, float y3, float thickness, ALLEGRO_COLOR color, int colorKey);
+    // text centered at x (top at y); lineHeight: to know where it goes
+    void AddText(const ALLEGRO_FONT *font, float x, float y, float lineHeight, const char *text, ALLEGRO_COLOR color, int colorKey);
+    // region (x1,y1)-(x2,y2) of a bitmap copied to the same place; bitmapKey: identifies the bitmap
+    void AddBitmapRegion(ALLEGRO_BITMAP *bitmap, int bitmapKey, float x1, float y1, float x2, float y2);
+
+    bool IsEmpty() const { return listCommands.empty(); }
+
+    // Draw everything recorded on the current target and empty the buffer.
+    // Return the number of Allegro draw calls made
+    int Flush();
+
+    // Drop everything recorded
+    void Clear();
+
+private:
+    enum Kind
+    {
+        KIND_BITMAP = 0,
+        KIND_SHAPE,
+        KIND_TEXT
+    };
+    struct Box
+    {
+        float x1, y1, x2, y2;
+        // (within a pixel: shapes that only touch may still share the pixels on the edge)
+        bool Overlaps(const Box &other) const { return x1 < other.x2 + 1 && other.x1 < x2 + 1 && y1 < other.y2 + 1 && other.y1 < y2 + 1; }
+    };
+    struct Command
+    {
+        int level;
+        int kind;
+        int key;
+        int seq;            // order recorded (ties keep it)
+        int begin, end;     // shape: vertices; text: characters
+        float x, y;         // text position
+        ALLEGRO_COLOR color;
+        const ALLEGRO_FONT *font;
+        ALLEGRO_BITMAP *bitmap;
+        Box box;
+    };
+    // bounding box of everything of one kind and key on one level
+    struct LevelEntry
+    {
+        int level;
+        int kind;
+        int key;
+        Box box;
+    };
+
+    void AddCommand(Command &cmd);
+    void BeginShape(Command &cmd, ALLEGRO_COLOR color, int colorKey);
+    void EndShape(Command &cmd, const Box &box);
+    void AddVertex(float x, float y, ALLEGRO_COLOR color);
+    void AddQuad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, ALLEGRO_COLOR color);
+    static int GetNumSegments(float rx, float ry);
+
+    std::vector<Command> listCommands;
+    std::vector<LevelEntry> listLevels;
+    std::vector<ALLEGRO_VERTEX> listVertices;       // as recorded
+    std::vector<ALLEGRO_VERTEX> listBatch;          // in drawing order
+    std::vector<char> listChars;
+};
+
+#endif /* ECGraphicCommandBuffer_h */
@@ -0,0 +1,125 @@
+#include "ECGraphicViewImp.h"
+#include "SimpleObserver.h"
+#include "../BACK_END/ECElevatorTraffic.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Drawing benchmark: a scripted ECSimpleGraphicObserver session on a headless view
+// (offscreen memory bitmap, software rendering: no display needed)
+//     ECGraphicViewBench [--frames N] [--floors N] [--ms-per-tick N] [--immediate] [--save file.png]
+// The simulation runs on its own thread at ms-per-tick (default 1: it moves on every
+// few frames); the script clicks a hall button every 30 frames, scrolls a floor up every
+// 100 frames (once the building is taller than the view) and pauses for 60 frames in the
+// middle. A frame is a timer event: the observer draws, the view ends it.
+// --floors: floors of the building (default 5)
+// Output: per-frame draw time (mean, p50, p99, max), draw calls per frame by primitive
+// and the calls that reached Allegro (batches, or one per draw call with --immediate).
+// --immediate: draw without the view's command buffer
+// --save: write the last frame to an image
+
+int main(int argc, char **argv)
+{
+    int numFrames = 2000;
+    int numFloors = 5;
+    int msPerTick = 1;
+    bool fImmediate = false;
+    const char *fileSave = NULL;
+    for(int i=1; i<argc; ++i)
+    {
+        if( strcmp(argv[i], "--frames") == 0 && i+1 < argc )
+        {
+            numFrames = atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--floors") == 0 && i+1 < argc )
+        {
+            numFloors = atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--ms-per-tick") == 0 && i+1 < argc )
+        {
+            msPerTick = atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "--immediate") == 0 )
+        {
+            fImmediate = true;
+        }
+        else if( strcmp(argv[i], "--save") == 0 && i+1 < argc )
+        {
+            fileSave = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--frames N] [--floors N] [--ms-per-tick N] [--immediate] [--save file.png]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if( numFrames <= 0 || numFloors < 2 )
+    {
+        fprintf(stderr, "Need at least one frame and two floors\n");
+        return 1;
+    }
+
+    std::vector<ECElevatorSimRequest> listRequests;
+    ECElevatorGenerateTraffic(EC_TRAFFIC_INTER_FLOOR, numFloors, 2000, 0.2, 11, listRequests);
+    int lenSim = listRequests.back().GetTime() + 100;
+    ECElevatorSim sim(numFloors, listRequests);
+
+    const int widthWin = 1000, heightWin = 1750;
+    ECGraphicViewImp view(widthWin, heightWin, true);
+    view.SetBatching(!fImmediate);
+    ECSimpleGraphicObserver obs(view, sim, lenSim, msPerTick);
+    view.Attach(&obs);
+
+    std::vector<double> listFrameTimes;
+    listFrameTimes.reserve(numFrames);
+    view.ResetDrawStats();
+    for(int frame=0; frame<numFrames; ++frame)
+    {
+        int buttonX, buttonY;
+        if( frame % 30 == 15 && obs.GetButtonCenter(1, 0, buttonX, buttonY) )
+        {
+            // the up button of floor 1, while it is in view
+            view.SetCursorPosition(buttonX, buttonY);
+            view.RunFrame(ECGV_EV_MOUSE_BUTTON_DOWN);
+        }
+        if( frame % 100 == 50 )
+        {
+            view.RunFrame(ECGV_EV_KEY_UP_UP);
+        }
+        if( frame == numFrames / 2 || frame == numFrames / 2 + 60 )
+        {
+            view.RunFrame(ECGV_EV_KEY_UP_SPACE);
+        }
+        auto tmStart = std::chrono::steady_clock::now();
+        view.RunFrame(ECGV_EV_TIMER);
+        listFrameTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tmStart).count());
+    }
+    view.Detach(&obs);
+
+    const ECGVDrawStats &stats = view.GetDrawStats();
+    std::vector<double> listSorted(listFrameTimes);
+    std::sort(listSorted.begin(), listSorted.end());
+    double total = 0.0;
+    for(double t : listFrameTimes)
+    {
+        total += t;
+    }
+    printf("frames,frames_drawn,mean_ms,p50_ms,p99_ms,max_ms\n");
+    printf("%d,%ld,%.3f,%.3f,%.3f,%.3f\n", numFrames, stats.numFrames, total / numFrames, listSorted[numFrames / 2], listSorted[(numFrames * 99) / 100], listSorted.back());
+    printf("primitive,calls,calls_per_frame\n");
+    for(int p = 0; p < ECGV_NUM_PRIMS; ++p)
+    {
+        printf("%s,%ld,%.1f\n", ECGVGetPrimitiveName((ECGVPrimitive)p), stats.counts[p], (double)stats.counts[p] / numFrames);
+    }
+    printf("allegro,%ld,%.1f\n", stats.numAllegroCalls, (double)stats.numAllegroCalls / numFrames);
+    if( fileSave != NULL && !view.SaveFrame(fileSave) )
+    {
+        fprintf(stderr, "Cannot save %s\n", fileSave);
+        return 1;
+    }
+    return 0;
+}
@@ -30,7 +30,14 @@ ALLEGRO_COLOR arrayAllegroColors[ECGV_NUM_COLORS] =
 // A graphic view implementation
 // This is built on top of Allegro library
 
-ECGraphicViewImp :: ECGraphicViewImp(int width, int height) : widthView(width), heightView(height), fRedraw(false), display(NULL), timer(NULL), event_queue(NULL)
+static const char *primitiveNames[ECGV_NUM_PRIMS] = {"line", "rectangle", "filled_rectangle", "circle", "filled_circle", "ellipse", "filled_ellipse", "text", "triangle", "filled_triangle", "layer"};
+
+const char *ECGVGetPrimitiveName(ECGVPrimitive prim)
+{
+    return primitiveNames[prim];
+}
+
+ECGraphicViewImp :: ECGraphicViewImp(int width, int height, bool fHeadless) : widthView(width), heightView(height), fRedraw(false), evtCurrent(ECGV_EV_NULL), fHeadless(fHeadless), bitmapOffscreen(NULL), cursorX(0), cursorY(0), fAutoClear(true), fBatching(true), display(NULL), event_queue(NULL), timer(NULL), fontDef(NULL)
 {
     Init();
 }
@@ -126,19 +133,114 @@ cout << "down:(" << cursorxDown <<"," << cursoryDown << ") up: (" << cursorxUp <
     }
 }
 
+// One event of a headless view: the body of Show's loop
+void ECGraphicViewImp :: RunFrame(ECGVEventType evt)
+{
+    evtCurrent = evt;
+    RenderStart();
+    Notify();
+    if( evtCurrent == ECGV_EV_TIMER && fRedraw )
+    {
+        RenderEnd();
+        fRedraw = false;
+    }
+}
+
+void ECGraphicViewImp :: SetCursorPosition(int cx, int cy)
+{
+    cursorX = cx;
+    cursorY = cy;
+}
+
+bool ECGraphicViewImp :: SaveFrame(const char *fileName)
+{
+    FlushCommands();
+    ALLEGRO_BITMAP *bitmap = fHeadless ? bitmapOffscreen : al_get_backbuffer(display);
+    return bitmap != NULL && al_save_bitmap(fileName, bitmap);
+}
+
+int ECGraphicViewImp :: CreateLayer()
+{
+    // same kind of bitmap as the frame: video for a display, memory when headless
+    ALLEGRO_BITMAP *layer = al_create_bitmap(widthView, heightView);
+    if( layer == NULL )
+    {
+        cout << "failed to create layer!\n";
+        exit(-1);
+    }
+    listLayers.push_back(layer);
+    return listLayers.size() - 1;
+}
+
+void ECGraphicViewImp :: BeginLayer(int layer)
+{
+    FlushCommands();
+    al_set_target_bitmap(listLayers[layer]);
+}
+
+void ECGraphicViewImp :: EndLayer()
+{
+    FlushCommands();
+    al_set_target_bitmap(fHeadless ? bitmapOffscreen : al_get_backbuffer(display));
+}
+
+void ECGraphicViewImp :: DrawLayer(int layer, int x1, int y1, int x2, int y2)
+{
+    ++statsDraw.counts[ECGV_PRIM_LAYER];
+    if( fBatching )
+    {
+        bufCommands.AddBitmapRegion(listLayers[layer], layer, x1, y1, x2, y2);
+        return;
+    }
+    ++statsDraw.numAllegroCalls;
+    al_draw_bitmap_region(listLayers[layer], x1, y1, x2 - x1, y2 - y1, x1, y1, 0);
+}
+
+void ECGraphicViewImp :: SetClip(int x1, int y1, int x2, int y2)
+{
+    FlushCommands();
+    al_set_clipping_rectangle(x1, y1, x2 - x1, y2 - y1);
+}
+
+void ECGraphicViewImp :: ResetClip()
+{
+    FlushCommands();
+    al_reset_clipping_rectangle();
+}
+
 void ECGraphicViewImp :: RenderStart()
 {
     //std::cout << "Redraw bitmap..." << GetPosX() << "," << GetPosY() << std::endl;
-    al_clear_to_color(al_map_rgb(255,255,255));
+    if( fAutoClear )
+    {
+        // whatever was recorded and not shown would be cleared anyway
+        bufCommands.Clear();
+        al_clear_to_color(al_map_rgb(255,255,255));
+    }
 }
 
 
 void ECGraphicViewImp :: RenderEnd()
 {
 //    al_draw_bitmap(algBitmap, GetPosX(), GetPosY(), 0);
-    al_flip_display();
+    FlushCommands();
+    ++statsDraw.numFrames;
+    if( !fHeadless )
+    {
+        al_flip_display();
+    }
 }
 
+void ECGraphicViewImp :: SetBatching(bool f)
+{
+    FlushCommands();
+    fBatching = f;
+}
+
+void ECGraphicViewImp :: FlushCommands()
+{
+    statsDraw.numAllegroCalls += bufCommands.Flush();
+}
     
 void ECGraphicViewImp :: Init()
 {
@@ -147,6 +249,11 @@ cout << "Start init..\n";
         cout << "failed to initialize allegro!\n";
         exit(-1);
     }
+    if( fHeadless )
+    {
+        InitHeadless();
+        return;
+    }
     
     if(!al_install_keyboard()) {
         cout << "failed to initialize the keyboard!\n";
@@ -188,6 +295,28 @@ cout << "Start init..\n";
     al_flip_display();
     al_start_timer(timer);
     
+    InitAddons();
+ 
+cout << "Done with initialization.\n";
+}
+
+void ECGraphicViewImp :: InitHeadless()
+{
+    // everything (the font's glyphs too) goes to memory bitmaps, drawn by the CPU
+    al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    bitmapOffscreen = al_create_bitmap(widthView, heightView);
+    if( bitmapOffscreen == NULL )
+    {
+        cout << "failed to create offscreen bitmap!\n";
+        exit(-1);
+    }
+    al_set_target_bitmap(bitmapOffscreen);
+    al_clear_to_color(al_map_rgb(255,255,255));
+    InitAddons();
+}
+
+void ECGraphicViewImp :: InitAddons()
+{
     // init image
     al_init_image_addon();
     al_init_primitives_addon();
@@ -200,13 +329,22 @@ cout << "Start init..\n";
     {
         cout << "Warning: font is not loaded!\n";
     }
- 
-cout << "Done with initialization.\n";
 }
 
 void ECGraphicViewImp :: Shutdown()
 {
     //
+    bufCommands.Clear();
+    for(auto layer : listLayers)
+    {
+        al_destroy_bitmap(layer);
+    }
+    listLayers.clear();
+    if( bitmapOffscreen != NULL )
+    {
+        al_destroy_bitmap(bitmapOffscreen);
+        bitmapOffscreen = NULL;
+    }
     if( display != NULL)
     {
         al_destroy_display(display);
@@ -322,6 +460,12 @@ ECGVEventType ECGraphicViewImp :: WaitForEvent()
 
 void ECGraphicViewImp :: GetCursorPosition(int &cx, int &cy) const
 {
+    if( fHeadless )
+    {
+        cx = cursorX;
+        cy = cursorY;
+        return;
+    }
     ALLEGRO_MOUSE_STATE state;
     al_get_mouse_state(&state);
     cx = state.x;
@@ -331,6 +475,13 @@ void ECGraphicViewImp :: GetCursorPosition(int &cx, int &cy) const
 // Drawing functions
 void  ECGraphicViewImp :: DrawLine(int x1, int y1, int x2, int y2, int thickness, ECGVColor color)
 {
+    ++statsDraw.counts[ECGV_PRIM_LINE];
+    if( fBatching )
+    {
+        bufCommands.AddLine(x1, y1, x2, y2, thickness, arrayAllegroColors[color], color);
+        return;
+    }
+    ++statsDraw.numAllegroCalls;
     // draw a line
     al_draw_line(x1,y1,x2,y2,arrayAllegroColors[color],thickness);
 //cout << "Draw line: (" << x1 << "," << y1 << " to (" << x2 << "," << y2 << ")\n";
@@ -338,43 +489,106 @@ void  ECGraphicViewImp :: DrawLine(int x1, int y1, int x2, int y2, int thickness
 
 void ECGraphicViewImp :: DrawRectangle(int x1, int y1, int x2, int y2, int thickness, ECGVColor color)
 {
+    ++statsDraw.counts[ECGV_PRIM_RECTANGLE];
+    if( fBatching )
+    {
+        bufCommands.AddRectangle(x1, y1, x2, y2, thickness, arrayAllegroColors[color], color);
+        return;
+    }
+    ++statsDraw.numAllegroCalls;
     al_draw_rectangle(x1, y1, x2, y2, arrayAllegroColors[color],thickness);
 }
 
 void ECGraphicViewImp :: DrawCircle(int xcenter, int ycenter, double radius, int thickness, ECGVColor color)
 {
+    ++statsDraw.counts[ECGV_PRIM_CIRCLE];
+    if( fBatching )
+    {
+        bufCommands.AddEllipse(xcenter, ycenter, radius, radius, thickness, arrayAllegroColors[color], color);
+        return;
+    }
+    ++statsDraw.numAllegroCalls;
     al_draw_circle(xcenter, ycenter, radius, arrayAllegroColors[color], thickness);
 }
 
 void ECGraphicViewImp :: DrawEllipse(int xcenter, int ycenter, double radiusx, double radiusy, int thickness, ECGVColor color)
 {
+    ++statsDraw.counts[ECGV_PRIM_ELLIPSE];
+    if( fBatching )
+    {
+        bufCommands.AddEllipse(xcenter, ycenter, radiusx, radiusy, thickness, arrayAllegroColors[color], color);
+        return;
+    }
+    ++statsDraw.numAllegroCalls;
     al_draw_ellipse(xcenter, ycenter, radiusx, radiusy, arrayAllegroColors[color], thickness);
 }
 
 void ECGraphicViewImp :: DrawFilledRectangle(int x1, int y1, int x2, int y2, ECGVColor color)
 {
-    al_draw_filled_rectangle(x1, y1, x2, y2, arrayAllegroColors[color]);;
+    ++statsDraw.counts[ECGV_PRIM_FILLED_RECTANGLE];
+    if( fBatching )
+    {
+        bufCommands.AddFilledRectangle(x1, y1, x2, y2, arrayAllegroColors[color], color);
+        return;
+    }
+    ++statsDraw.numAllegroCalls;
+    al_draw_filled_rectangle(x1, y1, x2, y2, arrayAllegroColors[color]);
 }
 
 void ECGraphicViewImp :: DrawFilledCircle(int xcenter, int ycenter, double radius, ECGVColor color)
 {
+    ++statsDraw.counts[ECGV_PRIM_FILLED_CIRCLE];
+    if( fBatching )
+    {
+        bufCommands.AddFilledEllipse(xcenter, ycenter, radius, radius, arrayAllegroColors[color], color);
+        return;
+    }
+    ++statsDraw.numAllegroCalls;
     al_draw_filled_circle(xcenter, ycenter, radius, arrayAllegroColors[color]);
 }
 
 void ECGraphicViewImp :: DrawFilledEllipse(int xcenter, int ycenter, double radiusx, double radiusy, ECGVColor color)
 {
+    ++statsDraw.counts[ECGV_PRIM_FILLED_ELLIPSE];
+    if( fBatching )
+    {
+        bufCommands.AddFilledEllipse(xcenter, ycenter, radiusx, radiusy, arrayAllegroColors[color], color);
+        return;
+    }
+    ++statsDraw.numAllegroCalls;
     al_draw_filled_ellipse(xcenter, ycenter, radiusx, radiusy, arrayAllegroColors[color]);
 }
 
 void ECGraphicViewImp :: DrawText(int xcenter, int ycenter, const char *ptext, ECGVColor color)
 {
+    ++statsDraw.counts[ECGV_PRIM_TEXT];
+    if( fBatching )
+    {
+        bufCommands.AddText(this->fontDef, xcenter, ycenter, al_get_font_line_height(this->fontDef), ptext, arrayAllegroColors[color], color);
+        return;
+    }
+    ++statsDraw.numAllegroCalls;
     al_draw_text(this->fontDef, arrayAllegroColors[color], xcenter, ycenter, ALLEGRO_ALIGN_CENTER, ptext);
 }
 
 void ECGraphicViewImp :: DrawTriangle(int x1, int y1, int x2, int y2, int x3, int y3, int thickness, ECGVColor color) {
+	++statsDraw.counts[ECGV_PRIM_TRIANGLE];
+	if( fBatching )
+	{
+		bufCommands.AddTriangle(x1, y1, x2, y2, x3, y3, thickness, arrayAllegroColors[color], color);
+		return;
+	}
+	++statsDraw.numAllegroCalls;
 	al_draw_triangle(x1, y1, x2, y2, x3, y3, arrayAllegroColors[color], thickness);
 }
 
 void ECGraphicViewImp :: DrawFilledTriangle(int x1, int y1, int x2, int y2, int x3, int y3, ECGVColor color) {
+	++statsDraw.counts[ECGV_PRIM_FILLED_TRIANGLE];
+	if( fBatching )
+	{
+		bufCommands.AddFilledTriangle(x1, y1, x2, y2, x3, y3, arrayAllegroColors[color], color);
+		return;
+	}
+	++statsDraw.numAllegroCalls;
 	al_draw_filled_triangle(x1, y1, x2, y2, x3, y3, arrayAllegroColors[color]);
 }
@@ -4,6 +4,7 @@
 #include <vector>
 #include <map>
 #include "ECObserver.h"
+#include "ECGraphicCommandBuffer.h"
 #include <allegro5/allegro.h>
 #include <allegro5/allegro_font.h>
 #include "../BACK_END/ECElevatorSim.h"
@@ -63,6 +64,35 @@ enum ECGVColor
 // Allegro color
 extern ALLEGRO_COLOR arrayAllegroColors[ECGV_NUM_COLORS];
 
+//***********************************************************
+// Drawing primitives (counted per frame, see ECGVDrawStats)
+
+enum ECGVPrimitive
+{
+    ECGV_PRIM_LINE = 0,
+    ECGV_PRIM_RECTANGLE,
+    ECGV_PRIM_FILLED_RECTANGLE,
+    ECGV_PRIM_CIRCLE,
+    ECGV_PRIM_FILLED_CIRCLE,
+    ECGV_PRIM_ELLIPSE,
+    ECGV_PRIM_FILLED_ELLIPSE,
+    ECGV_PRIM_TEXT,
+    ECGV_PRIM_TRIANGLE,
+    ECGV_PRIM_FILLED_TRIANGLE,
+    ECGV_PRIM_LAYER,            // region of a layer copied (DrawLayer)
+    ECGV_NUM_PRIMS
+};
+
+const char *ECGVGetPrimitiveName(ECGVPrimitive prim);
+
+// Draw calls made since the stats were reset
+struct ECGVDrawStats
+{
+    long numFrames = 0;
+    long counts[ECGV_NUM_PRIMS] = {0};
+    long numAllegroCalls = 0;   // calls that reached Allegro (batches when batching)
+};
+
 //***********************************************************
 // Drawing context (thickness and so on)
 
@@ -96,11 +126,51 @@ class ECGraphicViewImp : public ECObserverSubject
 {
 public:
     // Create a view with size (width, height)
-    ECGraphicViewImp(int width, int height);
+    // fHeadless: no display, timer, keyboard or mouse; frames are drawn into an offscreen
+    // memory bitmap (software rendering) and driven by RunFrame, e.g. to test or time
+    // the drawing on a machine without a display
+    ECGraphicViewImp(int width, int height, bool fHeadless = false);
     virtual ~ECGraphicViewImp();
     
     // Show the view. This would enter a forever loop, until quit is set. To do things you want to do, implement code for event handling
+    // (windowed only)
     void Show();
+
+    // Headless: process one event as Show would (notify the observers, then end the
+    // frame on a timer event if a redraw was asked for)
+    void RunFrame(ECGVEventType evt);
+    bool IsHeadless() const { return fHeadless; }
+    // Headless: where GetCursorPosition says the mouse is (for scripted clicks)
+    void SetCursorPosition(int cx, int cy);
+    // Save the current frame to an image file (e.g., .png, .bmp)
+    bool SaveFrame(const char *fileName);
+
+    // Clear the frame at the start of each event (the default). Turn it off when the
+    // observers put the whole frame together themselves (e.g., from layers)
+    void SetAutoClear(bool f) { fAutoClear = f; }
+
+    // Layers: offscreen bitmaps of the view's size that keep what is drawn on them
+    // across frames (e.g., the parts of a scene that don't change). Between BeginLayer
+    // and EndLayer the Draw* functions draw on the layer instead of the frame.
+    int CreateLayer();
+    void BeginLayer(int layer);
+    void EndLayer();
+    // Copy the region (x1,y1)-(x2,y2) of a layer to the same place of what is drawn on
+    void DrawLayer(int layer, int x1, int y1, int x2, int y2);
+
+    // Only draw inside (x1,y1)-(x2,y2) of what is drawn on, until ResetClip
+    void SetClip(int x1, int y1, int x2, int y2);
+    void ResetClip();
+
+    // Batching (the default): the Draw* functions record into a command buffer, drawn
+    // in a few large batches when the frame ends or before the target or clipping
+    // changes (see ECGraphicCommandBuffer). Off: each Draw* goes to Allegro right away
+    void SetBatching(bool f);
+    bool IsBatching() const { return fBatching; }
+
+    // Draw calls per primitive, and frames ended
+    const ECGVDrawStats& GetDrawStats() const { return statsDraw; }
+    void ResetDrawStats() { statsDraw = ECGVDrawStats(); }
     
     // Set flag to redraw (or not). Invoke SetRedraw(true) after you make changes to the view
     void SetRedraw(bool f) { fRedraw = f; }
@@ -132,11 +202,15 @@ private:
     // Internal functions
     // Initialize and reset view
     void Init();
+    void InitHeadless();
+    void InitAddons();
     void Shutdown();
     
     // View utiltiles
     void RenderStart();
     void RenderEnd();
+    // Draw what is recorded so far
+    void FlushCommands();
     
     // Process event
     ECGVEventType  WaitForEvent();
@@ -152,6 +226,20 @@ private:
     // keep track of what happened to view
     ECGVEventType evtCurrent;
     
+    // headless: offscreen target and the scripted cursor
+    bool fHeadless;
+    ALLEGRO_BITMAP *bitmapOffscreen;
+    int cursorX;
+    int cursorY;
+
+    ECGVDrawStats statsDraw;
+
+    bool fAutoClear;
+    std::vector<ALLEGRO_BITMAP *> listLayers;
+
+    bool fBatching;
+    ECGraphicCommandBuffer bufCommands;
+
     // allegro stuff
     ALLEGRO_DISPLAY *display;
     ALLEGRO_EVENT_QUEUE *event_queue;
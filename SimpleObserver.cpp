@@ -8,33 +8,54 @@
 
 //************************************************************
 
-ECSimpleGraphicObserver::ECSimpleGraphicObserver(ECGraphicViewImp &viewIn, ECElevatorSim &simIn, int totalTicksIn) : view(viewIn), sim(simIn), totalTicks(totalTicksIn), movingUp(false), movingDown(false), cabinSpeed(5), targetY(-1), numPassengersCabin(0), paused(false), isMoving(false), waitingForFrontEnd(false)
+// progress bar
+static const int barX = 100;
+static const int barY = 20;
+static const int barWidth = 800;
+static const int barHeight = 20;
+
+// building: below the progress bar; a floor is between minFloorHeight (the buttons
+// and the cabin's text still fit) and maxFloorHeight pixels high
+static const int buildingTop = 50;
+static const int minFloorHeight = 80;
+static const int maxFloorHeight = 300;
+
+// hall buttons and the dots of the passengers waiting next to them
+static const int buttonRadius = 15;
+static const int buttonX = 550;
+static const int dotRadius = 5;
+static const int dotSpacing = 15;
+
+ECSimpleGraphicObserver::ECSimpleGraphicObserver(ECGraphicViewImp &viewIn, ECElevatorSim &simIn, int totalTicksIn, int msPerTickIn) : view(viewIn), sim(simIn), msPerTick(msPerTickIn), runner(simIn, totalTicksIn, std::chrono::milliseconds(msPerTick)), cabinLevel(0), totalFloors(std::max(1, simIn.GetNumFloors())), scrollY(0), fFollowCabin(true), fLayoutChanged(false), layerStatic(-1), layerScene(-1), fSceneDrawn(false), paused(false), totalTicks(totalTicksIn)
 {
 
-  cabinY = 1450;
-
-  // // y-coords of center of each floor
-  // floorPositions[0] = 1450; // Floor 1
-  // floorPositions[1] = 1150; // Floor 2
-  // floorPositions[2] = 850;  // Floor 3
-  // floorPositions[3] = 550;  // Floor 4
-  // floorPositions[4] = 250;  // Floor 5
-
-  //int totalFloors = 10;  // Adjustable
-  // int floorHeight = 300; // Spacing between floors
-  // int baseY = 1450;      // Starting position for floor 1
-
-  for (int i = 0; i < totalFloors; ++i) {
-    floorPositions.push_back(baseY - i * floorHeight);
-  } 
-
-
-  // creates array for waiting passengers at each floor
-  for (int i = 0; i < totalFloors; ++i)
-  {
-    waitingPassengers[i][0] = 0; // UP
-    waitingPassengers[i][1] = 0; // DOWN
-  }
+  // as tall as 1500 pixels allow (scroll for the rest), within what the drawing needs
+  floorHeight = std::min(maxFloorHeight, std::max(minFloorHeight, 1500 / totalFloors));
+  baseY = view.GetHeight() - floorHeight;
+
+  // everything per floor is kept for the floors in view only: as many as fit at the
+  // smallest zoom
+  int maxFloorsShown = (view.GetHeight() - buildingTop) / minFloorHeight + 2;
+  stateDrawn.waiting.reserve(2 * maxFloorsShown);
+  stateCurrent.waiting.reserve(2 * maxFloorsShown);
+  buttons.reserve(2 * maxFloorsShown);
+
+  // the buttons only depend on the floor positions: built again only when the view scrolls or zooms
+  CreateButtons();
+
+  // retained scene: the frame is put together from the layers, not cleared
+  view.SetAutoClear(false);
+  layerStatic = view.CreateLayer();
+  layerScene = view.CreateLayer();
+  BuildStaticLayer();
+  listDirty.reserve(2 + 2 * maxFloorsShown);
+
+  // hall buttons push requests into the running simulation
+  sim.EnableInjection();
+
+  // the view draws 60 frames a second: the cabin covers a floor in a tick
+  cabinSpeed = std::max(1, floorHeight * 1000 / (60 * std::max(1, msPerTick)));
+  runner.Start();
 }
 
 
@@ -45,252 +66,406 @@ void ECSimpleGraphicObserver::Update()
   if (evt == ECGV_EV_KEY_UP_SPACE) {
     // Toggle paused state
     paused = !paused;
+    runner.SetPaused(paused);
     std::cout << "Paused state: " << (paused ? "PAUSED" : "RUNNING") << std::endl;
     return;
   }
-  if (evt == ECGV_EV_TIMER && !paused) {
-    if (waitingForFrontEnd) {
-      // Check if the front-end has caught up
-      if (cabinY == floorPositions[sim.GetCurrFloor() - 1]) {
-        waitingForFrontEnd = false;
-        //std::cout << "Front-end synchronized with back-end. Proceeding with back-end." << std::endl;
+  if (evt == ECGV_EV_KEY_UP_UP || evt == ECGV_EV_KEY_UP_DOWN) {
+    // a floor up or down; the view stays there until G
+    fFollowCabin = false;
+    Scroll((evt == ECGV_EV_KEY_UP_UP) ? floorHeight : -floorHeight);
+    return;
+  }
+  if (evt == ECGV_EV_KEY_UP_RIGHT || evt == ECGV_EV_KEY_UP_LEFT) {
+    Zoom((evt == ECGV_EV_KEY_UP_RIGHT) ? floorHeight * 5 / 4 : floorHeight * 4 / 5);
+    return;
+  }
+  if (evt == ECGV_EV_KEY_UP_G) {
+    fFollowCabin = true;
+    return;
+  }
+  if (evt == ECGV_EV_MOUSE_BUTTON_DOWN) {
+    int x, y;
+    view.GetCursorPosition(x, y);
+    for (const auto &button : buttons) {
+      if (IsClickOnButton(x, y, button)) {
+        // a hall call going one floor in the button's direction; taken in at the next tick
+        int floorSrc = button.floor + 1;
+        int floorDest = (button.direction == 0) ? floorSrc + 1 : floorSrc - 1;
+        // (the passenger shows up in the snapshot of that tick)
+        sim.InjectRequest(floorSrc, floorDest);
+        break;
       }
     }
-    if(!waitingForFrontEnd) {
-      // Advance the simulation by one tick if not paused and we haven't reached the total time  
-      if (sim.GetCurrentTime() < totalTicks) {
-        // std::cout << "sim curr time  " << sim.GetCurrentTime() << std::endl;
-        // std::cout << "total ticks " << totalTicks << std::endl;
-        sim.AdvanceOneTick();
-        //std::this_thread::sleep_for(std::chrono::milliseconds(100)); // Simulate delay
-        auto &requests = sim.GetListRequests();
-        for (auto &request : requests) {
-          int srcFloor = request.GetFloorSrc();          // 1-based floor from request
-          int floorIndex = srcFloor - 1;                 // 0-based for waitingPassengers
-          int direction = request.IsGoingUp() ? 0 : 1;
-
-          // Add passengers at the time they appear
-          if ((!request.IsServiced() && !request.IsFloorRequestDone() && request.GetTime() == sim.GetCurrentTime()) || (!request.IsServiced() && sim.GetCurrFloor() == 2) && sim.GetCurrentTime() == 4 && request.GetTime() == 3) {
-            //std::cout << "Request source floor: " << srcFloor << ", floorIndex: " << floorIndex << std::endl;
-            waitingPassengers[floorIndex][direction]++;
-            view.SetRedraw(true);
-          }
-          if ((!request.IsServiced() && !request.IsFloorRequestDone() && sim.GetCurrFloor() == srcFloor && request.GetTime() <= sim.GetCurrentTime()) || (!request.IsServiced() && sim.GetCurrFloor() == 3) && sim.GetCurrentTime() == 5 && request.GetTime() == 3) {
-            if (waitingPassengers[floorIndex][direction] > 0) {
-              waitingPassengers[floorIndex][direction]--;
-              view.SetRedraw(true);
-            }
-          }
-        }
-        if (sim.GetCurrDir() == EC_ELEVATOR_UP && !movingUp) {
-          // if (sim.GetCurrFloor() < totalFloors) {
-          // std::cout << "flor index " << floorPositions[sim.GetCurrFloor()-1] << std::endl;
-          // std::cout << "curr floor " << sim.GetCurrFloor() << std::endl;
-            targetY = floorPositions[sim.GetCurrFloor()];
-            movingUp = true;
-            movingDown = false;
-            isMoving = true;
-          // }
-        } else if (sim.GetCurrDir() == EC_ELEVATOR_DOWN && !movingDown) {
-          if (sim.GetCurrFloor() > 1) {
-            targetY = floorPositions[sim.GetCurrFloor() - 2];
-            movingDown = true;
-            movingUp = false;
-            isMoving = true;
-          }
-        }
-        waitingForFrontEnd = true;
-      }
-    } 
-
-    if(isMoving) {
-      MoveElevator();
+    return;
+  }
+  if (evt == ECGV_EV_TIMER) {
+    // the newest tick the simulation thread has published: drawing never holds the
+    // simulation up, and the cabin catches up with it on its own
+    const ECElevatorSnapshot &snapshot = runner.GetSnapshot();
+    if (!paused) {
+      MoveElevator((std::min(snapshot.currFloor, totalFloors) - 1) * floorHeight);
+    }
+    if (fFollowCabin) {
+      FollowCabin();
+    }
+    if (fLayoutChanged) {
+      // other floors in view: lay them out and draw the whole scene again
+      CreateButtons();
+      BuildStaticLayer();
+      fSceneDrawn = false;
+      fLayoutChanged = false;
     }
 
-    // Clear the screen
-    view.DrawFilledRectangle(0, 0, view.GetWidth(), view.GetHeight(), ECGV_WHITE);
+    // only what changed since the last frame is drawn again; nothing changed: no frame
+    RedrawElevatorSystem(snapshot);
+  }
+}
 
+void ECSimpleGraphicObserver::MoveElevator(int targetLevel) {
+  // a floor per tick at cabinSpeed; faster when more than a floor behind
+  int dist = std::abs(targetLevel - cabinLevel);
+  int step = std::max(cabinSpeed, dist - floorHeight);
+  if (dist <= step) {
+    cabinLevel = targetLevel;
+  }
+  else {
+    cabinLevel += (targetLevel > cabinLevel) ? step : -step;
+  }
+}
 
-    // view.DrawRectangle(100, 100, 500, 400, 3, ECGV_BLACK);   // Floor 5
-    // view.DrawRectangle(100, 400, 500, 700, 3, ECGV_BLACK);   // Floor 4
-    // view.DrawRectangle(100, 700, 500, 1000, 3, ECGV_BLACK);  // Floor 3
-    // view.DrawRectangle(100, 1000, 500, 1300, 3, ECGV_BLACK); // Floor 2
-    // view.DrawRectangle(100, 1300, 500, 1600, 3, ECGV_BLACK); // Floor 1
+int ECSimpleGraphicObserver::GetCurrentFloor()
+{
+  // the floor nearest to the cabin
+  int closestFloor = (cabinLevel + floorHeight / 2) / floorHeight + 1;
+  return std::max(1, std::min(totalFloors, closestFloor));
+}
 
-    int shaftX1 = 100, shaftX2 = 500;
+//************************************************************
+// Scrolling and zoom
 
-    for (int i = 0; i < totalFloors; ++i) {
-        int yPos = floorPositions[i];
-        view.DrawRectangle(shaftX1, yPos - floorHeight / 2, shaftX2, yPos + floorHeight / 2, 3, ECGV_BLACK);
-    }
+int ECSimpleGraphicObserver::GetFloorY(int floor) const
+{
+  return baseY - floor * floorHeight + scrollY;
+}
 
+void ECSimpleGraphicObserver::GetVisibleFloors(int &floorFirst, int &floorLast) const
+{
+  // floors whose rectangle reaches into the building (give or take one out of view)
+  int y0 = GetFloorY(0);
+  floorFirst = std::max(0, (y0 - floorHeight / 2 - view.GetHeight()) / floorHeight);
+  floorLast = std::min(totalFloors - 1, (y0 + floorHeight / 2 - buildingTop) / floorHeight);
+}
 
-    // Draw the elevator cabin
-    //cabinY = floorPositions[sim.GetCurrFloor() - 1];
-    ECGVColor cabinColor = (sim.GetCurrInElevator() > 0) ? ECGV_BLUE : ECGV_RED;
-    view.DrawFilledRectangle(150, cabinY - 100, 450, cabinY + 100, cabinColor);
+int ECSimpleGraphicObserver::GetCabinY() const
+{
+  return GetFloorY(0) - cabinLevel;
+}
 
-    // Draw buttons for each floor
-    CreateButtons();
-    for (const auto &button : buttons) {
-      view.DrawFilledCircle(button.centerX, button.centerY, button.width / 2, button.color);
-    }
+void ECSimpleGraphicObserver::Scroll(int dy)
+{
+  int scrollOld = scrollY;
+  scrollY += dy;
+  ClampScroll();
+  if (scrollY != scrollOld) {
+    fLayoutChanged = true;
+  }
+}
+
+void ECSimpleGraphicObserver::Zoom(int floorHeightNew)
+{
+  floorHeightNew = std::min(maxFloorHeight, std::max(minFloorHeight, floorHeightNew));
+  if (floorHeightNew == floorHeight) {
+    return;
+  }
+  // what is in the middle of the building stays there
+  int midY = (buildingTop + view.GetHeight()) / 2;
+  int level = (GetFloorY(0) - midY) * floorHeightNew / floorHeight;
+  cabinLevel = cabinLevel * floorHeightNew / floorHeight;
+  floorHeight = floorHeightNew;
+  baseY = view.GetHeight() - floorHeight;
+  scrollY = midY + level - baseY;
+  ClampScroll();
+  cabinSpeed = std::max(1, floorHeight * 1000 / (60 * std::max(1, msPerTick)));
+  fLayoutChanged = true;
+}
 
-    DrawWaitingPassengers();
+void ECSimpleGraphicObserver::FollowCabin()
+{
+  // once the cabin leaves the building's part of the view, center it
+  Rect rectCabin = GetCabinRect(GetCabinY());
+  Rect rectBuilding = GetBuildingRect();
+  if (rectCabin.y1 >= rectBuilding.y1 && rectCabin.y2 <= rectBuilding.y2) {
+    return;
+  }
+  Scroll((rectBuilding.y1 + rectBuilding.y2) / 2 - GetCabinY());
+}
+
+void ECSimpleGraphicObserver::ClampScroll()
+{
+  // from floor 1 at the bottom up to the top floor's ceiling at the top
+  int scrollMax = std::max(0, buildingTop - (baseY - (totalFloors - 1) * floorHeight - floorHeight / 2));
+  scrollY = std::max(0, std::min(scrollMax, scrollY));
+}
+
+void ECSimpleGraphicObserver::DrawProgressBar(int progressWidth, int progressPct)
+{
+  int startX = barX;
+  int startY = barY;
+
+  // Draw the background (unfilled portion)
+  view.DrawFilledRectangle(startX, startY, startX + barWidth, startY + barHeight, ECGV_WHITE);
 
-    // cout text
-    std::string buffer = std::to_string(sim.GetCurrInElevator()) + " in elevator";
-    view.DrawText(300, cabinY, buffer.c_str(), ECGV_WHITE);
+  // Draw the filled portion based on progress
+  view.DrawFilledRectangle(startX, startY, startX + progressWidth, startY + barHeight, ECGV_GREEN);
 
-    // Draw the progress bar
-    DrawProgressBar();
+  // Draw the border
+  view.DrawRectangle(startX, startY, startX + barWidth, startY + barHeight, 2, ECGV_BLACK);
 
-    view.SetRedraw(true);
+  // Optional: Add progress percentage text
+  std::string progressText = std::to_string(progressPct) + "%";
+  view.DrawText(startX + barWidth / 2, startY - 10, progressText.c_str(), ECGV_BLACK);
+}
+
+//************************************************************
+// Retained scene
+
+void ECSimpleGraphicObserver::BuildStaticLayer()
+{
+  view.BeginLayer(layerStatic);
+  view.DrawFilledRectangle(0, 0, view.GetWidth(), view.GetHeight(), ECGV_WHITE);
+
+  // the floors in view only
+  Rect rectBuilding = GetBuildingRect();
+  view.SetClip(rectBuilding.x1, rectBuilding.y1, rectBuilding.x2, rectBuilding.y2);
+  int shaftX1 = 100, shaftX2 = 500;
+  int floorFirst, floorLast;
+  GetVisibleFloors(floorFirst, floorLast);
+  for (int i = floorFirst; i <= floorLast; ++i) {
+    int yPos = GetFloorY(i);
+    view.DrawRectangle(shaftX1, yPos - floorHeight / 2, shaftX2, yPos + floorHeight / 2, 3, ECGV_BLACK);
+  }
+
+  // Draw buttons for each floor
+  for (const auto &button : buttons) {
+    view.DrawFilledCircle(button.centerX, button.centerY, button.width / 2, button.color);
   }
+  view.ResetClip();
+  view.EndLayer();
 }
 
-void ECSimpleGraphicObserver::MoveElevator() {
-  if (targetY > 0) { // Ensure a valid target exists
-    if (cabinY <= targetY && movingDown) {
-      cabinY = std::min(cabinY + cabinSpeed, targetY); // Move down smoothly
-    } 
-    else if (cabinY >= targetY && movingUp) {
-      cabinY = std::max(cabinY - cabinSpeed, targetY); // Move up smoothly
-    }
+void ECSimpleGraphicObserver::RedrawElevatorSystem(const ECElevatorSnapshot &snapshot)
+{
+  // (kept across frames: no allocation)
+  SceneState &state = stateCurrent;
+  state.cabinY = GetCabinY();
+  state.numInElevator = snapshot.numInElevator;
+  float progress = static_cast<float>(snapshot.time) / totalTicks;
+  state.progressWidth = static_cast<int>(progress * barWidth);
+  state.progressPct = static_cast<int>(progress * 100);
+  int floorFirst, floorLast;
+  GetVisibleFloors(floorFirst, floorLast);
+  state.floorFirst = floorFirst;
+  state.waiting.clear();
+  for (int floor = floorFirst; floor <= floorLast; ++floor) {
+    state.waiting.push_back((floor < (int)snapshot.listWaitingUp.size()) ? snapshot.listWaitingUp[floor] : 0);
+    state.waiting.push_back((floor < (int)snapshot.listWaitingDown.size()) ? snapshot.listWaitingDown[floor] : 0);
+  }
 
-    // Prevent overshooting at boundaries
-    if (cabinY == floorPositions[totalFloors-1]) { 
-      cabinY = floorPositions[totalFloors-1];
-      movingUp = false;
-      targetY = -1; // Reset target
-      isMoving = false;
-      waitingForFrontEnd = false;
-    } 
-    else if (cabinY == floorPositions[0]) { // 1st floor
-      cabinY = floorPositions[0];
-      movingDown = false;
-      targetY = -1; // Reset target
-      isMoving = false;
-      waitingForFrontEnd = false;
+  // regions that changed since the last frame (old and new place of what moved)
+  listDirty.clear();
+  if (!fSceneDrawn || state.floorFirst != stateDrawn.floorFirst || state.waiting.size() != stateDrawn.waiting.size()) {
+    listDirty.push_back(Rect{0, 0, view.GetWidth(), view.GetHeight()});
+  }
+  else {
+    if (state.cabinY != stateDrawn.cabinY || state.numInElevator != stateDrawn.numInElevator) {
+      Rect rectOld = GetCabinRect(stateDrawn.cabinY), rectNew = GetCabinRect(state.cabinY);
+      listDirty.push_back(Rect{rectNew.x1, std::min(rectOld.y1, rectNew.y1), rectNew.x2, std::max(rectOld.y2, rectNew.y2)});
     }
-
-    // Stop moving when the target is reached
-    if (cabinY == targetY) {
-      //std::cout << "Reached target floor: Y = " << targetY << std::endl;
-      movingUp = false;
-      movingDown = false;
-      targetY = -1; // Reset target
-      isMoving = false;
-      waitingForFrontEnd = false;
+    for (size_t i = 0; i < state.waiting.size(); ++i) {
+      if (state.waiting[i] != stateDrawn.waiting[i]) {
+        int floor = state.floorFirst + i / 2, direction = i % 2;
+        listDirty.push_back(GetWaitingRect(floor, direction, std::max(state.waiting[i], stateDrawn.waiting[i])));
+      }
     }
+    if (state.progressWidth != stateDrawn.progressWidth || state.progressPct != stateDrawn.progressPct) {
+      listDirty.push_back(GetProgressRect());
+    }
+  }
+  if (listDirty.empty()) {
+    return;
+  }
+
+  // fix up the scene: static background of each region, then what is on top of it
+  view.BeginLayer(layerScene);
+  for (const auto &rect : listDirty) {
+    view.SetClip(rect.x1, rect.y1, rect.x2, rect.y2);
+    view.DrawLayer(layerStatic, rect.x1, rect.y1, rect.x2, rect.y2);
+    DrawDynamic(rect, state);
   }
+  view.ResetClip();
+  view.EndLayer();
+
+  view.DrawLayer(layerScene, 0, 0, view.GetWidth(), view.GetHeight());
+  view.SetRedraw(true);
+  stateDrawn = state;
+  fSceneDrawn = true;
 }
 
-int ECSimpleGraphicObserver::GetCurrentFloor()
+void ECSimpleGraphicObserver::DrawDynamic(const Rect &rect, const SceneState &state)
 {
-  int minDist = abs(cabinY - floorPositions[0]);
-  int closestFloor = 1;
-  for (int i = 1; i < 5; ++i)
-  {
-    int dist = abs(cabinY - floorPositions[i]);
-    if (dist < minDist)
-    {
-      minDist = dist;
-      closestFloor = i + 1;
+  // the building's part of rect: nothing of it goes over the progress bar
+  Rect rectBuilding = GetBuildingRect();
+  if (rect.Intersects(rectBuilding)) {
+    Rect rectClip{std::max(rect.x1, rectBuilding.x1), std::max(rect.y1, rectBuilding.y1), std::min(rect.x2, rectBuilding.x2), std::min(rect.y2, rectBuilding.y2)};
+    view.SetClip(rectClip.x1, rectClip.y1, rectClip.x2, rectClip.y2);
+
+    // Draw the elevator cabin
+    Rect rectCabin = GetCabinRect(state.cabinY);
+    if (rectClip.Intersects(rectCabin)) {
+      ECGVColor cabinColor = (state.numInElevator > 0) ? ECGV_BLUE : ECGV_RED;
+      view.DrawFilledRectangle(rectCabin.x1, rectCabin.y1, rectCabin.x2, rectCabin.y2, cabinColor);
+      std::string buffer = std::to_string(state.numInElevator) + " in elevator";
+      view.DrawText(300, state.cabinY - 15, buffer.c_str(), ECGV_WHITE);
     }
+
+    DrawWaitingPassengers(rectClip, state);
+    view.SetClip(rect.x1, rect.y1, rect.x2, rect.y2);
+  }
+
+  if (rect.Intersects(GetProgressRect())) {
+    DrawProgressBar(state.progressWidth, state.progressPct);
   }
-  return closestFloor;
 }
 
-void ECSimpleGraphicObserver::DrawProgressBar()
+ECSimpleGraphicObserver::Rect ECSimpleGraphicObserver::GetCabinRect(int y) const
 {
-  // Calculate progress
-  float progress = static_cast<float>(sim.GetCurrentTime()) / totalTicks;
-  int barWidth = 800; // Total width of the progress bar
-  int barHeight = 20; // Height of the progress bar
-  int startX = 100;   // Starting X position
-  int startY = 20;    // Starting Y position
+  // two thirds of a floor high (with room for the text)
+  int halfHeight = std::max(floorHeight / 3, 16);
+  return Rect{150, y - halfHeight, 450, y + halfHeight};
+}
 
-  // Draw the background (unfilled portion)
-  view.DrawFilledRectangle(startX, startY, startX + barWidth, startY + barHeight, ECGV_WHITE);
+ECSimpleGraphicObserver::Rect ECSimpleGraphicObserver::GetWaitingRect(int floor, int direction, int numPassengers) const
+{
+  // the dots of DrawWaitingPassengers, centered on the button's height, and the count
+  // next to them if they don't all fit
+  int x = GetWaitingX(direction);
+  int y = GetButtonY(floor, direction);
+  int numDots = std::min(numPassengers, GetMaxDots());
+  int halfHeight = ((numDots - 1) * dotSpacing) / 2 + dotRadius + 2;
+  Rect rect{x - dotRadius - 2, y - halfHeight, x + dotRadius + 2, y + halfHeight + 1};
+  if (numPassengers > numDots) {
+    int xCount = (direction == 0) ? x - 45 : x + 45;
+    rect.x1 = std::min(rect.x1, xCount - 40);
+    rect.x2 = std::max(rect.x2, xCount + 40);
+    rect.y1 = std::min(rect.y1, y - 17);
+    rect.y2 = std::max(rect.y2, y + 17);
+  }
+  return rect;
+}
 
-  // Draw the filled portion based on progress
-  view.DrawFilledRectangle(startX, startY, startX + static_cast<int>(progress * barWidth), startY + barHeight, ECGV_GREEN);
+ECSimpleGraphicObserver::Rect ECSimpleGraphicObserver::GetProgressRect() const
+{
+  // the percentage text sits above the bar's top
+  return Rect{barX - 2, 0, barX + barWidth + 2, barY + barHeight + 2};
+}
 
-  // Draw the border
-  view.DrawRectangle(startX, startY, startX + barWidth, startY + barHeight, 2, ECGV_BLACK);
+ECSimpleGraphicObserver::Rect ECSimpleGraphicObserver::GetBuildingRect() const
+{
+  return Rect{0, buildingTop, view.GetWidth(), view.GetHeight()};
+}
 
-  // Optional: Add progress percentage text
-  std::string progressText = std::to_string(static_cast<int>(progress * 100)) + "%";
-  view.DrawText(startX + barWidth / 2, startY - 10, progressText.c_str(), ECGV_BLACK);
+int ECSimpleGraphicObserver::GetWaitingX(int direction) const
+{
+  // UP: dots on the left of the button, DOWN: on the right (5 pixels from it)
+  return (direction == 0) ? buttonX - buttonRadius - dotRadius - 5 : buttonX + buttonRadius + dotRadius + 5;
 }
 
-void ECSimpleGraphicObserver::CreateButtons() {
-    const int buttonRadius = 15; // Radius for circular buttons
-    const int buttonX = 550;    // X-coordinate for all buttons
+int ECSimpleGraphicObserver::GetButtonY(int floor, int direction) const
+{
+  return GetFloorY(floor) + ((direction == 0) ? -(buttonRadius + 5) : buttonRadius + 5);
+}
 
-    buttons.clear(); // Clear any existing buttons
+int ECSimpleGraphicObserver::GetMaxDots() const
+{
+  // as many as fit in a floor
+  return std::max(1, (floorHeight - 20) / dotSpacing);
+}
 
-    for (int floor = 0; floor < totalFloors; ++floor) {
-        int buttonY = floorPositions[floor]; // Dynamically calculate Y based on floor positions
+bool ECSimpleGraphicObserver::GetButtonCenter(int floor, int direction, int &x, int &y) const
+{
+  for (const auto &button : buttons) {
+    if (button.floor == floor - 1 && button.direction == direction) {
+      x = button.centerX;
+      y = button.centerY;
+      return true;
+    }
+  }
+  return false;
+}
 
+void ECSimpleGraphicObserver::CreateButtons() {
+    buttons.clear(); // Clear any existing buttons
+
+    // the floors in view only
+    int floorFirst, floorLast;
+    GetVisibleFloors(floorFirst, floorLast);
+    for (int floor = floorFirst; floor <= floorLast; ++floor) {
         // Create UP buttons for all floors except the top floor
         if (floor < totalFloors - 1) {
-          Button upButton{buttonX, buttonY - buttonRadius - 5, buttonRadius * 2, buttonRadius * 2, floor, 0, ECGV_GREEN};
+          Button upButton{buttonX, GetButtonY(floor, 0), buttonRadius * 2, buttonRadius * 2, floor, 0, ECGV_GREEN};
           buttons.push_back(upButton);
         }
 
         // Create DOWN buttons for all floors except the bottom floor
         if (floor > 0) {
-          Button downButton{buttonX, buttonY + buttonRadius + 5, buttonRadius * 2, buttonRadius * 2, floor, 1, ECGV_RED};
+          Button downButton{buttonX, GetButtonY(floor, 1), buttonRadius * 2, buttonRadius * 2, floor, 1, ECGV_RED};
           buttons.push_back(downButton);
         }
     }
 }
 
 
-void ECSimpleGraphicObserver::DrawWaitingPassengers() {
-  // Define dot properties
-  const int dotRadius = 5;     // Radius of each dot
-  const int dotSpacing = 15;   // Vertical spacing between dots
+bool ECSimpleGraphicObserver::IsClickOnButton(int x, int y, const Button &button) {
+  int dx = x - button.centerX;
+  int dy = y - button.centerY;
+  int radius = button.width / 2;
+  return dx * dx + dy * dy <= radius * radius;
+}
 
-  // Iterate through each floor
-  for (int floor = 0; floor < totalFloors; ++floor) {
+void ECSimpleGraphicObserver::DrawWaitingPassengers(const Rect &rect, const SceneState &state) {
+  // at most a floor's worth of dots per button: the cost of a frame doesn't grow with the crowd
+  int maxDots = GetMaxDots();
+
+  // Iterate through each floor shown
+  int numFloorsShown = state.waiting.size() / 2;
+  for (int i = 0; i < numFloorsShown; ++i) {
+    int floor = state.floorFirst + i;
     // Iterate through each direction: 0 = UP, 1 = DOWN
     for (int direction = 0; direction < 2; ++direction) {
-      int numPassengers = waitingPassengers[floor][direction];
+      int numPassengers = state.waiting[2 * i + direction];
       if (numPassengers <= 0) continue; // No passengers waiting in this direction
+      if (!rect.Intersects(GetWaitingRect(floor, direction, numPassengers))) continue;
 
-      // Find the corresponding button for this floor and direction
-      for (const auto &button : buttons) {
-        if (button.floor == floor && button.direction == direction) {
-          // Calculate the starting position for dots
-          int startX, startY;
-
-          if (direction == 0) { // UP - Dots on the left side
-              startX = button.centerX - (button.width / 2) - dotRadius - 5; // 5 pixels offset from the button
-          } else { // DOWN - Dots on the right side
-            startX = button.centerX + (button.width / 2) + dotRadius + 5; // 5 pixels offset from the button
-          }
-
-          // Starting Y position (topmost dot)
-          startY = button.centerY - ((numPassengers - 1) * dotSpacing) / 2;
-          // std::cout << "Drawing dots at Floor: " << (floor + 1) 
-          //                     << ", Direction: " << (direction == 0 ? "UP" : "DOWN")
-          //                     << ", StartX: " << startX << ", StartY: " << startY << std::endl;
-
-          // Draw a dot for each passenger
-          for (int i = 0; i < numPassengers; ++i) {
-            int dotY = startY + i * dotSpacing;
-            ECGVColor dotColor = (direction == 0) ? ECGV_GREEN : ECGV_RED;
-
-            // Draw the dot
-            view.DrawFilledCircle(startX, dotY, dotRadius, dotColor);
-          }
-
-          break; // Found the button, no need to continue searching
-        }
+      // a column of dots next to the button, centered on its height
+      int startX = GetWaitingX(direction);
+      int buttonY = GetButtonY(floor, direction);
+      int numDots = std::min(numPassengers, maxDots);
+
+      // Starting Y position (topmost dot)
+      int startY = buttonY - ((numDots - 1) * dotSpacing) / 2;
+
+      // Draw a dot for each passenger
+      ECGVColor dotColor = (direction == 0) ? ECGV_GREEN : ECGV_RED;
+      for (int k = 0; k < numDots; ++k) {
+        view.DrawFilledCircle(startX, startY + k * dotSpacing, dotRadius, dotColor);
+      }
+
+      // more than fit: how many, next to the dots
+      if (numPassengers > numDots) {
+        std::string count = std::to_string(numPassengers);
+        view.DrawText((direction == 0) ? startX - 45 : startX + 45, buttonY - 15, count.c_str(), ECGV_BLACK);
       }
     }
   }
-}
\ No newline at end of file
+}
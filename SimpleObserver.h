@@ -6,31 +6,52 @@
 #include <vector>
 #include <iostream>
 #include "../BACK_END/ECElevatorSim.h"
+#include "../BACK_END/ECElevatorSimRunner.h"
 
 //************************************************************
 class ECSimpleGraphicObserver : public ECObserver
 {
 public:
-    ECSimpleGraphicObserver( ECGraphicViewImp &viewIn, ECElevatorSim &simIn, int totalTicks );
+    // msPerTick: wall time of a simulation tick
+    ECSimpleGraphicObserver( ECGraphicViewImp &viewIn, ECElevatorSim &simIn, int totalTicks, int msPerTick = 500 );
     virtual void Update();
 
+    // Where the hall button of floor (1-based) and direction (0=up, 1=down) is on the
+    // view; false if it isn't shown (e.g., for scripted clicks)
+    bool GetButtonCenter(int floor, int direction, int &x, int &y) const;
+
     
 private:
     ECGraphicViewImp &view;
     ECElevatorSim &sim;
-    int cabinY;          // y-coord of cabin
-    bool movingUp;     
-    bool movingDown;     
-    int cabinSpeed;     
-    int targetY;         // y-coord of where the next nearest floor is at
-    std::vector<int> floorPositions; // y-coords of the floors
-    int totalFloors = 5;
-    int floorHeight = 1500 / totalFloors; // Spacing between floors
-    int baseY = 1750 - floorHeight;      // Starting position for floor 1
+    int msPerTick;
+    // runs the simulation on its own thread; the view only reads its snapshots
+    ECElevatorSimRunner runner;
+    int cabinLevel;      // height of the cabin above floor 1, in pixels
+    int cabinSpeed;      // pixels per frame
+    int totalFloors;
+    int floorHeight;     // Spacing between floors (zoom)
+    int baseY;           // y-coord of floor 1 when not scrolled
+    int scrollY;         // pixels scrolled up
+
+    // Virtualized building: only the floors in the view are laid out and drawn, so a
+    // frame costs the same for 5 floors or 500. Up/down keys scroll a floor, left/right
+    // zoom out/in, G goes back to following the cabin (the default: the view scrolls
+    // when the cabin leaves it)
+    bool fFollowCabin;
+    bool fLayoutChanged;
+    int GetFloorY(int floor) const;         // y-coord of the center of floor (0-based)
+    void GetVisibleFloors(int &floorFirst, int &floorLast) const;
+    int GetCabinY() const;
+    void Scroll(int dy);
+    void Zoom(int floorHeightNew);
+    void FollowCabin();
+    void ClampScroll();
 
     // void DrawEverything();
-    void DrawProgressBar();
-    void MoveElevator();
+    void DrawProgressBar(int progressWidth, int progressPct);
+    // move the cabin a frame's worth towards targetLevel
+    void MoveElevator(int targetLevel);
     int GetNextFloorY(bool goingUp);
     int GetCurrentFloor();
 
@@ -49,20 +70,47 @@ private:
     void CreateButtons();
     bool IsClickOnButton(int x, int y, const Button &button);
     
-    void DrawWaitingPassengers();
+    // Retained scene: the shaft, floors and buttons are drawn once on a static layer;
+    // the frame is kept on a scene layer where only the regions of what changed since
+    // the last frame (cabin, waiting passengers, progress) are drawn again
+    struct Rect {
+    int x1, y1, x2, y2;
+    bool Intersects(const Rect &other) const { return x1 < other.x2 && other.x1 < x2 && y1 < other.y2 && other.y1 < y2; }
+    };
+    // what the scene shows
+    struct SceneState {
+    int cabinY = 0;
+    int numInElevator = 0;
+    int progressWidth = 0;
+    int progressPct = 0;
+    int floorFirst = 0;         // floors shown: floorFirst on (0-based)
+    std::vector<int> waiting;   // [2 * (floor - floorFirst) + direction], 0=up, 1=down
+    };
 
-    void RedrawElevatorSystem();
+    // only the passengers whose dots are in rect
+    void DrawWaitingPassengers(const Rect &rect, const SceneState &state);
 
-    int waitingPassengers[5][2]; // [floor][direction], 0=up, 1=down
+    void BuildStaticLayer();
+    void RedrawElevatorSystem(const ECElevatorSnapshot &snapshot);
+    // what is on top of the static layer, in rect
+    void DrawDynamic(const Rect &rect, const SceneState &state);
+    Rect GetCabinRect(int y) const;
+    Rect GetWaitingRect(int floor, int direction, int numPassengers) const;
+    Rect GetProgressRect() const;
+    Rect GetBuildingRect() const;
+    int GetWaitingX(int direction) const;
+    int GetButtonY(int floor, int direction) const;
+    int GetMaxDots() const;
 
-    // number of passengers in cabin
-    int numPassengersCabin;
+    int layerStatic;
+    int layerScene;
+    bool fSceneDrawn;
+    SceneState stateDrawn;
+    SceneState stateCurrent;
+    std::vector<Rect> listDirty;
 
     bool paused;
     int totalTicks;
-
-    bool isMoving;
-    bool waitingForFrontEnd;
 };
 
 #endif /* SimpleObserver_h */